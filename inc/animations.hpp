@@ -24,6 +24,7 @@ extern "C" {
  * --------------------------------------------------------------------------------------------
  */
 typedef struct _AniPack AniPack;
+typedef struct _AnimaxCtx AnimaxCtx;
 
 /* --------------------------------------------------------------------------------------------
  *  MACROS
@@ -69,6 +70,46 @@ typedef struct _AniPack AniPack;
 #define LED_TYPE rgb24
 #endif /* LED_TYPE */
 
+/* --------------------------------------------------------------------------------------------
+ * ANI_TILE_WIDTH / ANI_TILE_HEIGHT define
+ *
+ * Tile size for animations that walk the frame in tiles with ANI_ForEachSpan() or
+ * ANI_ForEachPixel(). 32x8 pixels of color and criteria plus two float tables is about 3KB,
+ * well within the 32KB data cache of the M7. Pass LEDI_WIDTH and 1 instead to walk row by row.
+ */
+#ifndef ANI_TILE_WIDTH
+#define ANI_TILE_WIDTH 32
+#endif /* ANI_TILE_WIDTH */
+
+#ifndef ANI_TILE_HEIGHT
+#define ANI_TILE_HEIGHT 8
+#endif /* ANI_TILE_HEIGHT */
+
+/* --------------------------------------------------------------------------------------------
+ * ANI_REMEMBER_LINKS define
+ *
+ * Number of pixels ANI_TAG_REMEMBRANCE animations can have on their pixList at once, shared
+ * by all of them. Each costs an AniPixLink, 12 bytes on the Teensy.
+ *
+ * Default is 256
+ */
+#ifndef ANI_REMEMBER_LINKS
+#define ANI_REMEMBER_LINKS 256
+#endif /* ANI_REMEMBER_LINKS */
+
+/* --------------------------------------------------------------------------------------------
+ * ANI_TIME_BUCKETS define
+ *
+ * Number of buckets in the render time histogram kept for every AniPack. Buckets are a quarter
+ * of an octave wide, 64 buckets cover render times up to 131ms. Longer times land in the last
+ * bucket.
+ *
+ * Default is 64
+ */
+#ifndef ANI_TIME_BUCKETS
+#define ANI_TIME_BUCKETS 64
+#endif /* ANI_TIME_BUCKETS */
+
 /* --------------------------------------------------------------------------------------------
  *  TYPES
  * --------------------------------------------------------------------------------------------
@@ -111,6 +152,17 @@ typedef uint16_t AniTags;
 /* Animation looks best for LED panels layed out in a grid */
 #define ANI_TAG_GRID_OPTIMIZED             0x0400
 
+/* Animation prepares itself when it becomes active. ANI_SwapAnimation() calls it once with
+ * parms.warmup set, it then precomputes whatever doesn't change between frames and draws nothing.
+ * It is called once more with parms.cooldown set when it goes inactive, to free what it holds
+ */
+#define ANI_TAG_WARMUP                     0x0800
+
+/* Animation writes every pixel of every frame it draws. When it is the only animation playing
+ * ANI_DrawAnimationFrame() lets it write straight into the LED buffer
+ */
+#define ANI_TAG_OPAQUE                     0x1000
+
 /* Macro to identify an animation intended for audio analysis only only */
 #define ANI_TAG_IS_AUDIO_ANALYSIS(t)      (((t) & (ANI_TAG_AUDIO_REACTIVE | ANI_TAG_VISUAL)) == \
                                             ANI_TAG_AUDIO_REACTIVE)
@@ -184,20 +236,18 @@ typedef uint8_t AniMod;
 /* End AniMod type */
 
 /* --------------------------------------------------------------------------------------------
- * AniPixel type
+ * AniPixLink type
  *
- * Desribes the state of an LED pixel.
+ * Links an LED pixel onto the pixList of an ANI_TAG_REMEMBRANCE animation. Links come from a
+ * small pool through ANI_RememberPix() so the pixels themselves don't carry a list node.
  *
  */
-typedef struct _AniPixel {
-    /* ANI_TAG_REMEMBRANCE animations can set this node to their animation pack */
+typedef struct _AniPixLink {
+    /* Placed on the pixList of the animation. Must be first */
     ListNode    node;
 
     uint16_t    pixNum;
-    uint16_t    crit; /* type AniCriteria */
-
-    CRGB       color;
-} AniPixel;
+} AniPixLink;
 
 /* --------------------------------------------------------------------------------------------
  * AniParms type
@@ -228,7 +278,7 @@ typedef struct _AniParms {
 
     uint8_t chance;
 
-    /* Used by tag ANI_TAG_REMEMBRANCE */
+    /* List of AniPixLink. Used by tag ANI_TAG_REMEMBRANCE */
     ListNode pixList;
 
     uint16_t fpsTarg;
@@ -268,17 +318,72 @@ typedef struct _AniParms {
             // void foo(maskType);
         } mask;
 
+        /* Valid for the ANIMAX_ animations */
+        struct {
+            /* Render context from ANIMAX_CreateCtx(). One per AniPack */
+            AnimaxCtx *ctx;
+
+            /* Noise engine to render with. AnoiseSrc type */
+            uint8_t noiseSrc;
+
+            /* Resolution to render at. AnimaxQuality type */
+            uint8_t quality;
+
+            /* Use the symmetry of the animation: polar wedge grid or half turn mirror */
+            bool polar;
+
+            /* Render time per frame in us the quality adapts to. 0 for the frame time of
+             * fpsTarg, ANIMAX_BUDGET_OFF to keep the quality as set
+             */
+            uint16_t budgetUs;
+
+            /* Keyframes per second the layers are rendered at, the frames in between blend the
+             * two keyframes around them. 0 renders the layers every frame
+             */
+            uint8_t keyframeHz;
+        } animax;
+
     } p;
 
     /* ~~~~ Internal Only fields ~~~~*/
     uint32_t startTime;
-    /* Used to determine how long of a gap is needed before playing this animation */
+    /* Time in ms this animation is due to draw its next frame, every fps2Ms(fpsTarg) */
     uint32_t delay;
     uint16_t last;
     uint8_t  value;
+    /* Set while ANI_SwapAnimation() warms up an ANI_TAG_WARMUP animation */
+    bool     warmup;
+    /* Set while an ANI_TAG_WARMUP animation that went inactive frees what it holds */
+    bool     cooldown;
+    /* Quality level an animation that adapts its render cost is at, 0 when it renders as
+     * configured. Shown by ANI_ReportRenderTimes()
+     */
+    uint8_t  level;
 
 } AniParms;
 
+/* --------------------------------------------------------------------------------------------
+ * AniTimes type
+ *
+ * Render times of an animation, measured around every call ANI_DrawAnimationFrame() makes to
+ * its function. Used internally, see ANI_ReportRenderTimes().
+ *
+ */
+typedef struct _AniTimes {
+    /* Number of frames measured */
+    uint32_t count;
+
+    /* Shortest and longest render time in us */
+    uint32_t minUs;
+    uint32_t maxUs;
+
+    /* Sum of all render times in us, for the mean */
+    uint64_t sumUs;
+
+    /* Histogram of the render times. Halved when a bucket is about to overflow */
+    uint16_t bucket[ANI_TIME_BUCKETS];
+} AniTimes;
+
 /* --------------------------------------------------------------------------------------------
  * AniFunc type
  *
@@ -330,9 +435,73 @@ struct _AniPack {
 
     /* The current criteria of this animation */
     uint16_t      currCriteria; /* AniCriteria type */
+
+    /* Slot in the pixel claims while active. 0xFF if it has none */
+    uint8_t       slot;
+
+    /* Render times of this animation since it was registered */
+    AniTimes      times;
 };
 
 
+/* --------------------------------------------------------------------------------------------
+ *  INLINE FUNCTIONS
+ * --------------------------------------------------------------------------------------------
+ */
+
+/* --------------------------------------------------------------------------------------------
+ *                 ANI_ForEachSpan()
+ * --------------------------------------------------------------------------------------------
+ * Description:    Walks the whole frame in TileW x TileH tiles, tile rows top to bottom and
+ *                 tiles left to right, and calls Body once for every row of every tile. The
+ *                 pixels of a span are contiguous in memory (pXY is row-major), so Body can
+ *                 index per pixel tables with PixNum + i. TileW = LEDI_WIDTH and TileH = 1
+ *                 walks the frame row by row.
+ *
+ * Parameters:     TileW, TileH - Tile size. Edge tiles are clipped to the frame
+ *                 Body - Called as Body(uint16_t X, uint16_t Y, uint32_t PixNum, uint16_t Count)
+ *                     for the Count pixels starting at X, Y. PixNum is pXY(X, Y)
+ *
+ * Returns:        void
+ */
+template <typename SpanBody>
+static inline void ANI_ForEachSpan(uint16_t TileW, uint16_t TileH, SpanBody &&Body)
+{
+    uint16_t tx, ty, y, yEnd, count;
+
+    for (ty = 0; ty < LEDI_HEIGHT; ty += TileH) {
+        yEnd = (ty + TileH < LEDI_HEIGHT) ? ty + TileH : LEDI_HEIGHT;
+        for (tx = 0; tx < LEDI_WIDTH; tx += TileW) {
+            count = (tx + TileW < LEDI_WIDTH) ? TileW : LEDI_WIDTH - tx;
+            for (y = ty; y < yEnd; y++) {
+                Body(tx, y, (uint32_t)pXY(tx, y), count);
+            }
+        }
+    }
+}
+
+/* --------------------------------------------------------------------------------------------
+ *                 ANI_ForEachPixel()
+ * --------------------------------------------------------------------------------------------
+ * Description:    Same walk as ANI_ForEachSpan() but calls Body for every pixel.
+ *
+ * Parameters:     TileW, TileH - Tile size. Edge tiles are clipped to the frame
+ *                 Body - Called as Body(uint16_t X, uint16_t Y, uint32_t PixNum)
+ *
+ * Returns:        void
+ */
+template <typename PixelBody>
+static inline void ANI_ForEachPixel(uint16_t TileW, uint16_t TileH, PixelBody &&Body)
+{
+    ANI_ForEachSpan(TileW, TileH, [&](uint16_t X, uint16_t Y, uint32_t PixNum, uint16_t Count) {
+        uint16_t i;
+
+        for (i = 0; i < Count; i++) {
+            Body((uint16_t)(X + i), Y, PixNum + i);
+        }
+    });
+}
+
 /* --------------------------------------------------------------------------------------------
  *  PUBLIC FUNCTIONS
  * --------------------------------------------------------------------------------------------
@@ -356,20 +525,51 @@ bool ANI_AddNextAnimationByFuncP(AniFunc FuncP, AniLayer OverrideLayer);
 void ANI_SwapAnimation(bool UseBlending);
 
 /* Checks if the current animation is allowed to write to this pixel */
-AniPixel *ANI_CheckPixNum(uint32_t PixNum);
+bool ANI_CheckPixNum(uint32_t PixNum);
 
-/* Checks if the current animation is allowed to write to this pixel */
-bool ANI_CheckPix(AniPixel *Pix);
+// Writes the pixel to the PixNum LED after ANI_CheckPixNum() allowed it
+void ANI_WriteVerifiedPix(AniParms *Ap, uint32_t PixNum, const CRGB &RgbVal);
 
-// Writes the pixel to the PixNum LED if it has permission to
-void ANI_WriteVerifiedPix(AniParms *Ap, AniPixel *Pix, const CRGB &RgbVal);
+/* Gets the color last written to a pixel */
+CRGB ANI_GetPixel(uint32_t PixNum);
+
+/* Puts a pixel on the pixList of an ANI_TAG_REMEMBRANCE animation */
+bool ANI_RememberPix(AniParms *Ap, uint32_t PixNum);
+
+/* Takes a pixel off the pixList it was put on by ANI_RememberPix() */
+void ANI_ForgetPix(AniPixLink *Link);
 
 // Writes the pixel to the PixNum LED if it has permission to
 void ANI_WritePixel(AniParms *Ap, uint32_t PixNum, const CRGB &RgbVal);
 
+/* Writes Count colors to the pixels starting at PixNum where it has permission to */
+uint16_t ANI_WriteSpan(AniParms *Ap, uint32_t PixNum, const CRGB *RgbVals, uint16_t Count);
+
+/* Writes one color to the Count pixels starting at PixNum where it has permission to */
+uint16_t ANI_FillSpan(AniParms *Ap, uint32_t PixNum, const CRGB &RgbVal, uint16_t Count);
+
+/* Writes H colors down the column at X starting at row Y where it has permission to */
+uint16_t ANI_WriteColumn(AniParms *Ap, int16_t X, int16_t Y, const CRGB *RgbVals, int16_t H);
+
+/* Writes one color to a W x H rectangle where it has permission to */
+uint16_t ANI_WriteRect(AniParms *Ap, int16_t X, int16_t Y, int16_t W, int16_t H,
+                       const CRGB &RgbVal);
+
+/* Flags which pixels of a span the current animation has permission to write */
+uint16_t ANI_WritableSpan(uint32_t PixNum, uint16_t Count, uint8_t *Writable);
+
 /* Fills out the LedBuff with animations :3 */
 uint32_t ANI_DrawAnimationFrame(rgb24 *LedBuff);
 
+/* Time in ms until ANI_DrawAnimationFrame() has an animation due to draw */
+uint32_t ANI_MsToNextFrame(void);
+
+/* Prints the render times of every registered animation */
+void ANI_ReportRenderTimes(void);
+
+/* Clears the render times of every registered animation */
+void ANI_ResetRenderTimes(void);
+
 
 /* Group: The following functions are animation functions of type AniFunc */
 
@@ -13,6 +13,7 @@
 
 #include "../inc/overide.h"
 #include "../inc/animations.hpp"
+#include "../inc/animaxnoise.hpp"
 
 /* --------------------------------------------------------------------------------------------
  *  CONSTANTS
@@ -41,6 +42,72 @@
 #define ANIMAX_DIRECTORY "/gifs/"
 #endif /* ANIMAX_DIRECTORY */
 
+/* --------------------------------------------------------------------------------------------
+ * ANIMAX_FRAME_BUDGET_US define
+ *
+ * Render time per frame in microseconds that an ANIMAX animation without an fpsTarg is held
+ * to. An animation that renders slower than its budget drops its quality step by step until it
+ * fits, and takes the steps back once there is room, so the audio and network work in the main
+ * loop keep getting time. A p.animax.budgetUs of 0 in its AniParms holds it to the frame time of
+ * its fpsTarg, or to this default when it has none. 0 here disables the adaptive quality of
+ * those without an fpsTarg. To disable it for one animation, set its budgetUs to
+ * ANIMAX_BUDGET_OFF.
+ *
+ * Default is 8000
+ */
+#ifndef ANIMAX_FRAME_BUDGET_US
+#define ANIMAX_FRAME_BUDGET_US 8000
+#endif /* ANIMAX_FRAME_BUDGET_US */
+
+/* --------------------------------------------------------------------------------------------
+ * ANIMAX_BUDGET_OFF define
+ *
+ * AniParms p.animax.budgetUs of an animation that always renders at the quality it is set to,
+ * whatever its fpsTarg and ANIMAX_FRAME_BUDGET_US are.
+ */
+#define ANIMAX_BUDGET_OFF 0xFFFF
+
+/* --------------------------------------------------------------------------------------------
+ * ANIMAX_ARENA_SIZE define
+ *
+ * Bytes of the arena the per sample values of an ANIMAX animation that don't change between
+ * frames are precomputed into when it is swapped in. The arena is shared by all animations and
+ * starts over when the next one doesn't fit. Planes that don't fit at all are computed every
+ * frame as before. 0 disables the arena.
+ *
+ * Default is 98304, the planes of ChasingSpirals at full quality
+ */
+#ifndef ANIMAX_ARENA_SIZE
+#define ANIMAX_ARENA_SIZE 98304
+#endif /* ANIMAX_ARENA_SIZE */
+
+/* --------------------------------------------------------------------------------------------
+ *  TYPES
+ * --------------------------------------------------------------------------------------------
+ */
+
+/* --------------------------------------------------------------------------------------------
+ * AnimaxQuality type
+ *
+ * Resolution an ANIMAX animation renders its layers at. Reduced qualities render one sample
+ * per block of pixels and upscale the colors to the full frame with a bilinear filter. The
+ * value is log2 of the block edge.
+ */
+typedef uint8_t AnimaxQuality;
+
+/* One sample per pixel */
+#define ANIMAX_QUALITY_FULL                0
+
+/* One sample per 2x2 pixels, about a quarter of the render time */
+#define ANIMAX_QUALITY_HALF                1
+
+/* One sample per 4x4 pixels. Only for very smooth animations */
+#define ANIMAX_QUALITY_QUARTER             2
+
+#define ANIMAX_NUM_QUALITY                 3
+
+/* End AnimaxQuality type */
+
 /* --------------------------------------------------------------------------------------------
  *  PUBLIC FUNCTIONS
  * --------------------------------------------------------------------------------------------
@@ -49,6 +116,9 @@
 
 bool ANIMAX_Init();
 
+/* Allocates the render context an AniPack playing an ANIMAX animation needs */
+AnimaxCtx *ANIMAX_CreateCtx();
+
 void ANIMAX_Lava1(AniParms *Ap);
 
 void ANIMAX_ChasingSpirals(AniParms *Ap);
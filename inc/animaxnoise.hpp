@@ -0,0 +1,213 @@
+/* ********************************************************************************************
+ * animaxnoise.hpp
+ *
+ * Author: Shawn Saenger
+ *
+ * Created: Oct 16, 2026
+ *
+ * Description: Noise kernels used by the ANIMartRIX animations. Provides a single sample
+ *              Perlin noise function and a batched version that fills whole rows (or whole
+ *              frames) of samples in one call, in float and in Q16.16 fixed point.
+ *
+ * ********************************************************************************************
+ */
+
+#ifndef _ANIMAXNOISE_HPP_
+#define _ANIMAXNOISE_HPP_
+
+#include "overide.h"
+#include <Arduino.h>
+
+/* --------------------------------------------------------------------------------------------
+ *  DEFINITIONS
+ * --------------------------------------------------------------------------------------------
+ */
+
+/* --------------------------------------------------------------------------------------------
+ * ANOISE_USE_SIMD define
+ *
+ * Host builds with SSE4.1, AVX2 or NEON enabled use vector kernels for the batched noise
+ * functions. Set to 0 to force the scalar kernels. The Teensy 4.x (Cortex-M7) has no vector
+ * unit and always uses the scalar kernels.
+ *
+ * Default is 1
+ */
+#ifndef ANOISE_USE_SIMD
+#define ANOISE_USE_SIMD 1
+#endif /* ANOISE_USE_SIMD */
+
+/* --------------------------------------------------------------------------------------------
+ * ANOISE_DIAGNOSTICS define
+ *
+ * Set to 1 to build ANOISE_ReportAccuracy(), which compares the fixed point noise against the
+ * float reference and times both, ANOISE_ReportFbm(), which times the one pass fBm kernel
+ * against one noise call per octave, and ANOISE_ReportSimplex(), which times simplex against
+ * Perlin noise. ANIMAX_Init() runs them once at boot when enabled.
+ *
+ * Default is 0
+ */
+#ifndef ANOISE_DIAGNOSTICS
+#define ANOISE_DIAGNOSTICS 0
+#endif /* ANOISE_DIAGNOSTICS */
+
+/* --------------------------------------------------------------------------------------------
+ * ANOISE_FBM_MAX_OCTAVES define
+ *
+ * Most octaves an animation layer can ask ANOISE_FbmBatch() for. Octaves past the 6th are
+ * finer than a LED at the scales the animations use.
+ *
+ * Default is 6
+ */
+#ifndef ANOISE_FBM_MAX_OCTAVES
+#define ANOISE_FBM_MAX_OCTAVES 6
+#endif /* ANOISE_FBM_MAX_OCTAVES */
+
+/* --------------------------------------------------------------------------------------------
+ * ANOISE_VOLUME_SIZE / ANOISE_VOLUME_DEPTH define
+ *
+ * Size in voxels of the precomputed noise volume used by ANOISE_SRC_VOLUME. SIZE is the x and
+ * y edge, DEPTH the z edge, which the animations mostly use for slow drift so it can be
+ * shallower. Both must be powers of 2. The volume takes SIZE * SIZE * DEPTH bytes, 64KB at the
+ * defaults. A full 64^3 volume is 256KB.
+ *
+ * Default is 64 and 16
+ */
+#ifndef ANOISE_VOLUME_SIZE
+#define ANOISE_VOLUME_SIZE 64
+#endif /* ANOISE_VOLUME_SIZE */
+
+#ifndef ANOISE_VOLUME_DEPTH
+#define ANOISE_VOLUME_DEPTH 16
+#endif /* ANOISE_VOLUME_DEPTH */
+
+#if ((ANOISE_VOLUME_SIZE & (ANOISE_VOLUME_SIZE - 1)) != 0) || \
+    ((ANOISE_VOLUME_DEPTH & (ANOISE_VOLUME_DEPTH - 1)) != 0)
+#error "ANOISE_VOLUME_SIZE and ANOISE_VOLUME_DEPTH must be powers of 2"
+#endif /* ANOISE_VOLUME_SIZE, ANOISE_VOLUME_DEPTH */
+
+/* --------------------------------------------------------------------------------------------
+ * ANOISE_VOLUME_RES define
+ *
+ * Voxels per noise unit in the noise volume. The volume repeats every
+ * ANOISE_VOLUME_SIZE / ANOISE_VOLUME_RES noise units in x and y and every
+ * ANOISE_VOLUME_DEPTH / ANOISE_VOLUME_RES units in z. Must be a power of 2.
+ *
+ * Default is 4
+ */
+#ifndef ANOISE_VOLUME_RES
+#define ANOISE_VOLUME_RES 4
+#endif /* ANOISE_VOLUME_RES */
+
+/* --------------------------------------------------------------------------------------------
+ * ANOISE_Q16_ONE define
+ *
+ * The value 1.0 in the Q16.16 fixed point format used by the fixed point noise functions.
+ */
+#define ANOISE_Q16_ONE 0x10000
+
+/* --------------------------------------------------------------------------------------------
+ *  TYPES
+ * --------------------------------------------------------------------------------------------
+ */
+
+/* --------------------------------------------------------------------------------------------
+ * AnoiseSrc type
+ *
+ * Selects the noise engine an animation renders with.
+ */
+typedef uint8_t AnoiseSrc;
+
+/* Single precision float Perlin noise. The reference */
+#define ANOISE_SRC_FLOAT                   0
+
+/* Q16.16 fixed point Perlin noise. Within a tenth of an LSB of ANOISE_SRC_FLOAT after
+ * scaling to 0-255, without any float math in the kernel. The ANIMAX layers convert their
+ * float coordinates in and the result out, which eats the gain on an FPU, so time both with
+ * ANOISE_ReportAccuracy() on the target before choosing it.
+ */
+#define ANOISE_SRC_FIXED                   1
+
+/* Trilinear lookups into a tileable noise volume built once by ANOISE_VolumeInit(). Not the
+ * same field as the gradient noise and it repeats every few units, but a sample costs 8 byte
+ * reads instead of 8 gradient evaluations. Meant for ambient animations.
+ */
+#define ANOISE_SRC_VOLUME                  2
+
+/* Single precision float simplex noise. 4 corners per sample instead of 8 and no grid aligned
+ * artifacts. Scaled to the spread of ANOISE_SRC_FLOAT, but a different field.
+ */
+#define ANOISE_SRC_SIMPLEX                 3
+
+/* End AnoiseSrc type */
+
+/* --------------------------------------------------------------------------------------------
+ *  INLINE FUNCTIONS
+ * --------------------------------------------------------------------------------------------
+ */
+
+/* Converts a noise coordinate to Q16.16. The noise repeats every 256 units so the integer
+ * part is first wrapped into -256 to 256, which keeps large coordinates in range.
+ */
+static inline int32_t ANOISE_FloatToQ16(float X)
+{
+    X -= 256.f * (float)(int32_t)(X * (1.f / 256));
+    return (int32_t)(X * (float)ANOISE_Q16_ONE);
+}
+
+/* --------------------------------------------------------------------------------------------
+ *  PUBLIC FUNCTIONS
+ * --------------------------------------------------------------------------------------------
+ */
+
+/* Classic 3D Perlin noise for a single sample. Returns roughly -1 to 1 */
+float ANOISE_Pnoise(float X, float Y, float Z);
+
+/* Classic 3D Perlin noise for Count samples. Out[i] = ANOISE_Pnoise(X[i], Y[i], Z[i]) */
+void ANOISE_PnoiseBatch(const float *X, const float *Y, const float *Z, float *Out,
+                        uint32_t Count);
+
+/* 3D simplex noise for a single sample, scaled to the spread of ANOISE_Pnoise() */
+float ANOISE_Snoise(float X, float Y, float Z);
+
+/* 3D simplex noise for Count samples. Out[i] = ANOISE_Snoise(X[i], Y[i], Z[i]) */
+void ANOISE_SnoiseBatch(const float *X, const float *Y, const float *Z, float *Out,
+                        uint32_t Count);
+
+/* Octaves octaves of Perlin noise summed as fBm, or as turbulence, for Count samples in one
+ * pass. Returns -1 to 1, or 0 to 1 for turbulence
+ */
+void ANOISE_FbmBatch(const float *X, const float *Y, const float *Z, float *Out,
+                     uint32_t Count, uint8_t Octaves, float Gain, bool Turbulence);
+
+/* Q16.16 fixed point Perlin noise for a single sample. Returns roughly -ANOISE_Q16_ONE to
+ * ANOISE_Q16_ONE
+ */
+int32_t ANOISE_PnoiseQ16(int32_t X, int32_t Y, int32_t Z);
+
+/* Q16.16 fixed point Perlin noise for Count samples */
+void ANOISE_PnoiseBatchQ16(const int32_t *X, const int32_t *Y, const int32_t *Z, int32_t *Out,
+                           uint32_t Count);
+
+/* Builds the noise volume for ANOISE_SRC_VOLUME. Call once at startup */
+bool ANOISE_VolumeInit(void);
+
+/* Trilinear sample of the noise volume for Count samples. Returns roughly -1 to 1 */
+void ANOISE_VolumeBatch(const float *X, const float *Y, const float *Z, float *Out,
+                        uint32_t Count);
+
+#if ANOISE_DIAGNOSTICS
+/* Prints the error of the fixed point noise against the float reference and the time both
+ * engines take per sample.
+ */
+void ANOISE_ReportAccuracy(uint32_t Samples);
+
+/* Prints the time per sample per octave of ANOISE_FbmBatch() against one ANOISE_PnoiseBatch()
+ * call per octave.
+ */
+void ANOISE_ReportFbm(uint32_t Samples);
+
+/* Prints the time simplex and Perlin noise take for the samples of one layer of a frame */
+void ANOISE_ReportSimplex(void);
+#endif /* ANOISE_DIAGNOSTICS */
+
+#endif /* _ANIMAXNOISE_HPP_ */
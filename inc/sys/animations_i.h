@@ -65,6 +65,59 @@ typedef uint16_t AniCriteria;
 
 /* End AniCriteria type */
 
+/* --------------------------------------------------------------------------------------------
+ * AniEpoch type
+ *
+ * Counts the frames drawn. Wraps around, so only the age of an epoch (the current epoch minus
+ * it) is meaningful. Used internally.
+ */
+typedef uint8_t AniEpoch;
+
+/* Ages are kept below this by rebasing every pixel once every this many frames */
+#define ANI_EPOCH_REBASE                   0x80
+
+/* End AniEpoch type */
+
+/* --------------------------------------------------------------------------------------------
+ * AniCritCode type
+ *
+ * An AniCriteria in a byte. A criteria a pixel can be written with has at most one bit set
+ * besides ANI_CRIT_PERSISTENT, so the code is the position of that bit from the bottom
+ * nibble up, times two, plus the persistent flag. Codes compare like the criteria they stand
+ * for. Used internally.
+ */
+typedef uint8_t AniCritCode;
+
+/* Number of codes, one for each bit from 0x0010 to ANI_CRIT_BLEND and for none, with and
+ * without ANI_CRIT_PERSISTENT
+ */
+#define ANI_CRIT_CODES                     20
+
+/* End AniCritCode type */
+
+/* --------------------------------------------------------------------------------------------
+ * AniClaim type
+ *
+ * Criteria a pixel was last written with, the epoch of the frame it was written in and the
+ * slot of the animation that wrote it. Kept side by side since every check of a pixel needs
+ * them, a byte each. Used internally.
+ */
+typedef struct _AniClaim {
+    AniCritCode crit;
+    AniEpoch    epoch;
+    uint8_t     slot;
+} AniClaim;
+
+/* Number of active animations that get a slot. Any more are drawn as usual but can't hold
+ * their pixels while they aren't due
+ */
+#define ANI_CLAIM_SLOTS                    16
+
+/* Slot of no animation */
+#define ANI_SLOT_NONE                      0xFF
+
+/* End AniClaim type */
+
 /* --------------------------------------------------------------------------------------------
  * AniInfo type
  *
@@ -92,15 +145,52 @@ typedef struct _AniInfo {
 
     bool        tranInProg;
 
-    /* The LED pixel number that was recently drawn to */
-    AniPixel   *pix;
+    /* Color and AniClaim of every LED pixel, as drawn so far. Indexed by pixel number. A
+     * claim only holds for the frame it was written in, after it the pixel reads as
+     * released. See AniPixCrit()
+     */
+    CRGB        *color;
+    AniClaim    *claim;
+
+    /* Epoch of the frame being drawn */
+    AniEpoch     epoch;
+
+    /* Pixels written before this epoch read as baseCrit, e.g. all pixels drop to
+     * ANI_CRIT_BELOW_LOW when a transition starts
+     */
+    AniEpoch     baseEpoch;
+    AniCriteria  baseCrit;
+
+    /* Claims of a slot written before this epoch are released. Moves to the current epoch
+     * every frame, except while the animation in the slot waits for its next frame so the
+     * pixels it drew last are kept
+     */
+    AniEpoch     heldEpoch[ANI_CLAIM_SLOTS];
+
+    /* One bit per slot, set while an active animation has it */
+    uint16_t     slotsUsed;
+
+    /* Pool of ANI_REMEMBER_LINKS AniPixLink. The unused ones are on freeLinks */
+    AniPixLink  *links;
+    ListNode     freeLinks;
 
-    uint16_t    fpsTarg;
+    /* One bit per LED pixel, set while the pixel is on a pixList */
+    uint8_t     *linked;
+
+    /* Time in ms the earliest active animation is due to draw its next frame */
     uint32_t    msDelay;
 
     /* Pointer to the current drawing buffer of size LEDI_NUM_LEDS */
     LED_TYPE   *drawBuff;
 
+    /* Set while the only active animation writes straight into drawBuff, skipping the color
+     * and criteria planes. See AniCanDrawDirect()
+     */
+    bool        direct;
+
+    /* Set when the active animations changed and direct has to be checked again */
+    bool        directCheck;
+
 } AniInfo;
 
 #endif /* _ANIMATIONS_I_H_ */
\ No newline at end of file
@@ -129,75 +129,103 @@ bool ANICOMP_Init(AniPack *Animations, uint8_t *NumAnimations)
     Animations[i].parms.fpsTarg = 100;
     i++;
     Animations[i].funcp = ANIFUNC_RainbowIris;
-    Animations[i].tags = (ANI_TAG_VISUAL);
+    Animations[i].tags = (ANI_TAG_VISUAL | ANI_TAG_OPAQUE);
     Animations[i].parms.speed = 1; /* How fast it changes between frames */
     Animations[i].parms.scale = 0; /* How much the rainbow color changes per frame */
     Animations[i].parms.fpsTarg = 40;
     i++;
     Animations[i].funcp = ANIFUNC_PlazInt;
-    Animations[i].tags = (ANI_TAG_VISUAL);
+    Animations[i].tags = (ANI_TAG_VISUAL | ANI_TAG_OPAQUE);
     Animations[i].parms.fpsTarg = 80;
     i++;
     Animations[i].funcp = GIFDEC_Play;
-    Animations[i].tags = (ANI_TAG_VISUAL | ANI_TAG_GRID_OPTIMIZED | ANI_TAG_GIF);
+    Animations[i].tags = (ANI_TAG_VISUAL | ANI_TAG_GRID_OPTIMIZED | ANI_TAG_GIF | ANI_TAG_OPAQUE);
     Animations[i].parms.fpsTarg = 20;
     Animations[i].parms.last = 1;
     i++;
     Animations[i].funcp = ANIMAX_Lava1;
-    Animations[i].tags = (ANI_TAG_VISUAL);
-    Animations[i].parms.fpsTarg = 400;
+    Animations[i].parms.p.animax.ctx = ANIMAX_CreateCtx();
+    Animations[i].tags = (ANI_TAG_VISUAL | ANI_TAG_WARMUP | ANI_TAG_OPAQUE);
+    Animations[i].parms.fpsTarg = 125; /* 8 ms, the render budget ANIMAX quality adapts to */
+    Animations[i].parms.p.animax.noiseSrc = ANOISE_SRC_VOLUME; /* Ambient, doesn't need exact noise */
+    Animations[i].parms.p.animax.quality = ANIMAX_QUALITY_HALF; /* Smooth, upscales cleanly */
+    Animations[i].parms.p.animax.keyframeHz = 20; /* Slow, blends cleanly */
     i++;
     Animations[i].funcp = ANIMAX_ChasingSpirals;
-    Animations[i].tags = (ANI_TAG_VISUAL);
-    Animations[i].parms.fpsTarg = 400;
+    Animations[i].parms.p.animax.ctx = ANIMAX_CreateCtx();
+    Animations[i].tags = (ANI_TAG_VISUAL | ANI_TAG_WARMUP | ANI_TAG_OPAQUE);
+    Animations[i].parms.fpsTarg = 125;
+    Animations[i].parms.p.animax.keyframeHz = 20; /* Slow, blends cleanly */
     i++;
     Animations[i].funcp = ANIMAX_Caleido1;
-    Animations[i].tags = (ANI_TAG_VISUAL);
-    Animations[i].parms.fpsTarg = 400;
+    Animations[i].parms.p.animax.ctx = ANIMAX_CreateCtx();
+    Animations[i].tags = (ANI_TAG_VISUAL | ANI_TAG_WARMUP | ANI_TAG_OPAQUE);
+    Animations[i].parms.fpsTarg = 125;
     i++;
     Animations[i].funcp = ANIMAX_Zoom;
-    Animations[i].tags = (ANI_TAG_VISUAL);
-    Animations[i].parms.fpsTarg = 400;
+    Animations[i].parms.p.animax.ctx = ANIMAX_CreateCtx();
+    Animations[i].tags = (ANI_TAG_VISUAL | ANI_TAG_WARMUP | ANI_TAG_OPAQUE);
+    Animations[i].parms.fpsTarg = 125;
+    Animations[i].parms.p.animax.keyframeHz = 20; /* Slow, blends cleanly */
     i++;
     Animations[i].funcp = ANIMAX_Rings;
-    Animations[i].tags = (ANI_TAG_VISUAL);
-    Animations[i].parms.fpsTarg = 400;
+    Animations[i].parms.p.animax.ctx = ANIMAX_CreateCtx();
+    Animations[i].tags = (ANI_TAG_VISUAL | ANI_TAG_WARMUP | ANI_TAG_OPAQUE);
+    Animations[i].parms.fpsTarg = 125;
+    Animations[i].parms.p.animax.polar = true; /* Radially symmetric */
     i++;
     Animations[i].funcp = ANIMAX_Waves;
-    Animations[i].tags = (ANI_TAG_VISUAL);
-    Animations[i].parms.fpsTarg = 400;
+    Animations[i].parms.p.animax.ctx = ANIMAX_CreateCtx();
+    Animations[i].tags = (ANI_TAG_VISUAL | ANI_TAG_WARMUP | ANI_TAG_OPAQUE);
+    Animations[i].parms.fpsTarg = 125;
     i++;
     Animations[i].funcp = ANIMAX_CenterField;
-    Animations[i].tags = (ANI_TAG_VISUAL);
-    Animations[i].parms.fpsTarg = 400;
+    Animations[i].parms.p.animax.ctx = ANIMAX_CreateCtx();
+    Animations[i].tags = (ANI_TAG_VISUAL | ANI_TAG_WARMUP | ANI_TAG_OPAQUE);
+    Animations[i].parms.fpsTarg = 125;
     i++;
     Animations[i].funcp = ANIMAX_Caleido2;
-    Animations[i].tags = (ANI_TAG_VISUAL);
-    Animations[i].parms.fpsTarg = 400;
+    Animations[i].parms.p.animax.ctx = ANIMAX_CreateCtx();
+    Animations[i].tags = (ANI_TAG_VISUAL | ANI_TAG_WARMUP | ANI_TAG_OPAQUE);
+    Animations[i].parms.fpsTarg = 125;
+    Animations[i].parms.p.animax.polar = true; /* 2-fold symmetric */
     i++;
     Animations[i].funcp = ANIMAX_Caleido3;
-    Animations[i].tags = (ANI_TAG_VISUAL);
-    Animations[i].parms.fpsTarg = 400;
+    Animations[i].parms.p.animax.ctx = ANIMAX_CreateCtx();
+    Animations[i].tags = (ANI_TAG_VISUAL | ANI_TAG_WARMUP | ANI_TAG_OPAQUE);
+    Animations[i].parms.fpsTarg = 125;
+    Animations[i].parms.p.animax.polar = true; /* 2-fold symmetric */
+    Animations[i].parms.p.animax.keyframeHz = 20; /* Slow, blends cleanly */
     i++;
     Animations[i].funcp = ANIMAX_Scaledemo1;
-    Animations[i].tags = (ANI_TAG_VISUAL);
-    Animations[i].parms.fpsTarg = 400;
+    Animations[i].parms.p.animax.ctx = ANIMAX_CreateCtx();
+    Animations[i].tags = (ANI_TAG_VISUAL | ANI_TAG_WARMUP | ANI_TAG_OPAQUE);
+    Animations[i].parms.fpsTarg = 125;
+    Animations[i].parms.p.animax.keyframeHz = 20; /* Slow, blends cleanly */
     i++;
     Animations[i].funcp = ANIMAX_Yves;
-    Animations[i].tags = (ANI_TAG_VISUAL);
-    Animations[i].parms.fpsTarg = 400;
+    Animations[i].parms.p.animax.ctx = ANIMAX_CreateCtx();
+    Animations[i].tags = (ANI_TAG_VISUAL | ANI_TAG_WARMUP | ANI_TAG_OPAQUE);
+    Animations[i].parms.fpsTarg = 125;
     i++;
     Animations[i].funcp = ANIMAX_Spiralus;
-    Animations[i].tags = (ANI_TAG_VISUAL);
-    Animations[i].parms.fpsTarg = 400;
+    Animations[i].parms.p.animax.ctx = ANIMAX_CreateCtx();
+    Animations[i].tags = (ANI_TAG_VISUAL | ANI_TAG_WARMUP | ANI_TAG_OPAQUE);
+    Animations[i].parms.fpsTarg = 125;
+    Animations[i].parms.p.animax.polar = true; /* 2-fold symmetric */
     i++;
     Animations[i].funcp = ANIMAX_Spiralus2;
-    Animations[i].tags = (ANI_TAG_VISUAL);
-    Animations[i].parms.fpsTarg = 400;
+    Animations[i].parms.p.animax.ctx = ANIMAX_CreateCtx();
+    Animations[i].tags = (ANI_TAG_VISUAL | ANI_TAG_WARMUP | ANI_TAG_OPAQUE);
+    Animations[i].parms.fpsTarg = 125;
     i++;
     Animations[i].funcp = Animax_HotBlob;
-    Animations[i].tags = (ANI_TAG_VISUAL);
-    Animations[i].parms.fpsTarg = 400;
+    Animations[i].parms.p.animax.ctx = ANIMAX_CreateCtx();
+    Animations[i].tags = (ANI_TAG_VISUAL | ANI_TAG_WARMUP | ANI_TAG_OPAQUE);
+    Animations[i].parms.fpsTarg = 125;
+    Animations[i].parms.p.animax.noiseSrc = ANOISE_SRC_VOLUME; /* Ambient, doesn't need exact noise */
+    Animations[i].parms.p.animax.quality = ANIMAX_QUALITY_HALF; /* Smooth, upscales cleanly */
+    Animations[i].parms.p.animax.keyframeHz = 20; /* Slow, blends cleanly */
     i++;
     
 #if 0
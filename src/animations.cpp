@@ -37,6 +37,13 @@
 static AniInfo     aniInfo;
 static uint16_t    numWritten;
 static AniCriteria currAc;
+static uint8_t     currSlot;
+
+/* AniCriteria of every AniCritCode */
+static const AniCriteria aniCritOf[ANI_CRIT_CODES] = {
+    0x0000, 0x0001, 0x0010, 0x0011, 0x0020, 0x0021, 0x0040, 0x0041, 0x0080, 0x0081,
+    0x0100, 0x0101, 0x0200, 0x0201, 0x0400, 0x0401, 0x0800, 0x0801, 0x1000, 0x1001
+};
 
 /* --------------------------------------------------------------------------------------------
  *  PROTOTYPES
@@ -44,6 +51,19 @@ static AniCriteria currAc;
  */
 static void AniSetInactive(AniPack *Ap);
 static void AniTransDone();
+static inline bool AniCanWrite(AniCriteria Crit, AniCriteria PixCrit);
+static inline AniCriteria AniPixCrit(uint32_t PixNum);
+static inline AniCritCode AniEncodeCrit(AniCriteria Crit);
+static void AniNextEpoch(void);
+static uint16_t AniWriteRun(uint32_t PixNum, uint16_t Stride, const CRGB *RgbVals, uint8_t Step,
+                            uint16_t Count);
+static bool AniCanDrawDirect(void);
+static void AniLeaveDirect(void);
+static void AniDrawTimed(AniPack *Ap);
+static void AniClearTimes(AniTimes *Times);
+static uint8_t AniTimeBucket(uint32_t Us);
+static uint32_t AniBucketUs(uint8_t Bucket);
+static void AniReportTimes(ListNode *List);
 
 /* --------------------------------------------------------------------------------------------
  *  PUBLIC FUNCTIONS
@@ -82,18 +102,36 @@ bool ANI_Init(void)
     InitList(&aniInfo.queueList);
     aniInfo.numMainWaiting = 0;
     aniInfo.numTransWaiting = 0;
-
-    aniInfo.pix = (AniPixel*)malloc(sizeof(AniPixel) * LEDI_NUM_LEDS);
-    if (aniInfo.pix == 0) {
+    aniInfo.direct = false;
+    aniInfo.directCheck = true;
+
+    aniInfo.color = (CRGB*)malloc(sizeof(CRGB) * LEDI_NUM_LEDS);
+    aniInfo.claim = (AniClaim*)malloc(sizeof(AniClaim) * LEDI_NUM_LEDS);
+    aniInfo.links = (AniPixLink*)malloc(sizeof(AniPixLink) * ANI_REMEMBER_LINKS);
+    aniInfo.linked = (uint8_t*)calloc((LEDI_NUM_LEDS + 7) / 8, 1);
+    if (aniInfo.color == 0 || aniInfo.claim == 0 || aniInfo.links == 0 || aniInfo.linked == 0) {
         Serial.println("Could not allocate memory for animations");
         return false;
     }
 
     for (i = 0; i < LEDI_NUM_LEDS; i++) {
-        InitNode(&aniInfo.pix[i].node);
-        aniInfo.pix[i].pixNum = i;
-        aniInfo.pix[i].color.setRGB(0, 0, 0);
-        aniInfo.pix[i].crit = ANI_CRIT_DEFAULT;
+        aniInfo.color[i] = CRGB::Black;
+        aniInfo.claim[i].crit = AniEncodeCrit(ANI_CRIT_DEFAULT);
+        aniInfo.claim[i].epoch = 0;
+        aniInfo.claim[i].slot = ANI_SLOT_NONE;
+    }
+    aniInfo.epoch = 0;
+    aniInfo.baseEpoch = 0;
+    aniInfo.baseCrit = ANI_CRIT_DEFAULT;
+    for (i = 0; i < ANI_CLAIM_SLOTS; i++) {
+        aniInfo.heldEpoch[i] = 0;
+    }
+    aniInfo.slotsUsed = 0;
+    aniInfo.msDelay = 0;
+
+    InitList(&aniInfo.freeLinks);
+    for (i = 0; i < ANI_REMEMBER_LINKS; i++) {
+        InsertTail(&aniInfo.freeLinks, &aniInfo.links[i].node);
     }
 
     return true;
@@ -131,6 +169,8 @@ bool ANI_RegisterAnimation(AniPack *Ap, AniLayer DefaultLayer)
     Serial.println("ANI_RegisterAnimation 1");
     InitNode(&Ap->node);
     Ap->defaultLayer = DefaultLayer;
+    Ap->slot = ANI_SLOT_NONE;
+    AniClearTimes(&Ap->times);
 
     if (DefaultLayer & ANI_LAYER_TRANSITION) {
         /* Place this in the waiting main list */
@@ -298,6 +338,7 @@ void ANI_SwapAnimation(bool UseBlending)
     bool      inserted;
     bool      transPresent = false;
 
+    AniLeaveDirect();
 
     /* Step 1: Check if any trans animations are present in the queue list */
     IterateList(aniInfo.queueList, aniPack, AniPack *) {
@@ -317,9 +358,9 @@ void ANI_SwapAnimation(bool UseBlending)
     //Serial.println("ANI_SwapAnimation: step 2");
     if (transPresent) {
         //Serial.println("ANI_SwapAnimation: transpresent");
-        for (i = 0; i < LEDI_NUM_LEDS; i++) {
-            aniInfo.pix[i].crit = ANI_CRIT_BELOW_LOW;
-        }
+        /* From the next frame on, every pixel not written since is held by the old animations */
+        aniInfo.baseEpoch = aniInfo.epoch + 1;
+        aniInfo.baseCrit = ANI_CRIT_BELOW_LOW;
         /* Like IterateListSafely(), this while loop lets you safely remove
          * a node from a list while iterating through it.
          */
@@ -345,12 +386,12 @@ void ANI_SwapAnimation(bool UseBlending)
         }
         /* Since no transaction, black out all the pixels */
         for (i = 0; i < LEDI_NUM_LEDS; i++) {
-            aniInfo.pix[i].color = 0;
+            aniInfo.color[i] = 0;
         }
     }
 
-    /* Step 3: Move all animations from queue list to active list */
-    aniInfo.fpsTarg = 0;
+    /* Step 3: Move all animations from queue list to active list. They are all due now */
+    aniInfo.msDelay = millis();
     while (!IsListEmpty(&aniInfo.queueList)) {
         aniPack = (AniPack*)GetHead(&aniInfo.queueList);
         //Serial.printf("ANI_SwapAnimation: queue type 0x%x\r\n", aniPack->currCriteria);
@@ -358,7 +399,21 @@ void ANI_SwapAnimation(bool UseBlending)
         aniPack->parms.startTime = millis();
         aniPack->parms.delay = millis();
         aniPack->parms.value = 0;
-        aniInfo.fpsTarg = max(aniInfo.fpsTarg, aniPack->parms.fpsTarg);
+
+        /* Take the first free slot, if there is one */
+        for (i = 0; i < ANI_CLAIM_SLOTS && (aniInfo.slotsUsed & (1 << i)); i++) {
+        }
+        if (i < ANI_CLAIM_SLOTS) {
+            aniInfo.slotsUsed |= 1 << i;
+            aniPack->slot = i;
+        }
+
+        /* Let the animation prepare itself before its first frame */
+        if (aniPack->tags & ANI_TAG_WARMUP) {
+            aniPack->parms.warmup = true;
+            aniPack->funcp(&aniPack->parms);
+            aniPack->parms.warmup = false;
+        }
 
         /* Insert into the active list in its appropriate spot */
         inserted = false;
@@ -383,59 +438,22 @@ void ANI_SwapAnimation(bool UseBlending)
 /* --------------------------------------------------------------------------------------------
  *                 ANI_CheckPixNum()
  * --------------------------------------------------------------------------------------------
- * Description:    
+ * Description:    Checks if the animation being drawn may write to a pixel
  *
- * Parameters:     
+ * Parameters:     PixNum - The pixel number
  *
- * Returns:        
+ * Returns:        true if ANI_WriteVerifiedPix() can write the pixel, false otherwise
  */
-AniPixel *ANI_CheckPixNum(uint32_t PixNum)
+bool ANI_CheckPixNum(uint32_t PixNum)
 {
-    AniPixel *pix;
-    if (PixNum >= LEDI_NUM_LEDS) {
-        return 0;
-    }
-    pix = &aniInfo.pix[PixNum];
+    AniCriteria crit;
 
-    if ((currAc >= pix->crit) || ((pix)->crit == ANI_CRIT_BLEND)) {
-        switch (currAc) {
-        case ANI_CRIT_BELOW_LOW:
-        case ANI_CRIT_BELOW_MEDIUM:
-        case ANI_CRIT_BELOW_HIGH:
-        case ANI_CRIT_BELOW_HIGH_PERSISTENT:
-            // Only the animations being transitioned out can write to
-            // this pixel
-            if ((pix->crit & ANI_CRIT_BELOW_ANY) != 0) {
-                Serial.println("ANI_CheckPixNum returns 0 first");
-                return 0;
-            }
-            break;
-        
-        default:
-            if (pix->crit & ANI_CRIT_BELOW_ANY) {
-                // Anything that is not an exclusive can't write
-                // to this pixel
-                Serial.println("ANI_CheckPixNum returns 0 second");
-                return 0;
-            }
-        }
-        return pix;
+    if (PixNum >= LEDI_NUM_LEDS) {
+        return false;
     }
-    return 0;
-}
+    crit = AniPixCrit(PixNum);
 
-/* --------------------------------------------------------------------------------------------
- *                 ANI_CheckPix()
- * --------------------------------------------------------------------------------------------
- * Description:    
- *
- * Parameters:     
- *
- * Returns:        
- */
-bool ANI_CheckPix(AniPixel *Pix)
-{
-    if ((currAc >= Pix->crit) || (Pix->crit == ANI_CRIT_BLEND)) {
+    if ((currAc >= crit) || (crit == ANI_CRIT_BLEND)) {
         switch (currAc) {
         case ANI_CRIT_BELOW_LOW:
         case ANI_CRIT_BELOW_MEDIUM:
@@ -443,16 +461,16 @@ bool ANI_CheckPix(AniPixel *Pix)
         case ANI_CRIT_BELOW_HIGH_PERSISTENT:
             // Only the animations being transitioned out can write to
             // this pixel
-            if ((Pix->crit & ANI_CRIT_BELOW_ANY) != 0) {
-                return 0;
+            if ((crit & ANI_CRIT_BELOW_ANY) != 0) {
+                return false;
             }
             break;
         
         default:
-            if (Pix->crit & ANI_CRIT_BELOW_ANY) {
+            if (crit & ANI_CRIT_BELOW_ANY) {
                 // Anything that is not an exclusive can't write
                 // to this pixel
-                return 0;
+                return false;
             }
         }
         return true;
@@ -463,16 +481,21 @@ bool ANI_CheckPix(AniPixel *Pix)
 /* --------------------------------------------------------------------------------------------
  *                 ANI_WriteVerifiedPix()
  * --------------------------------------------------------------------------------------------
- * Description:    
+ * Description:    Writes a pixel that ANI_CheckPixNum() allowed the animation to write
  *
- * Parameters:     
+ * Parameters:     Ap - Pointer to animation parameters
+ *                 PixNum - The pixel number
+ *                 RgbVal - Color to write
  *
- * Returns:        
+ * Returns:        void
  */
-void ANI_WriteVerifiedPix(AniParms *Ap, AniPixel *Pix, const CRGB &RgbVal)
+void ANI_WriteVerifiedPix(AniParms *Ap, uint32_t PixNum, const CRGB &RgbVal)
 {
     AniCriteria  currCrit = currAc;
-    if (Pix->crit == ANI_CRIT_BLEND) {
+    if (aniInfo.direct) {
+        aniInfo.drawBuff[PixNum] = LED_TYPE(RgbVal);
+        numWritten++;
+    } else if (AniPixCrit(PixNum) == ANI_CRIT_BLEND) {
 
     } else {
 
@@ -494,12 +517,82 @@ void ANI_WriteVerifiedPix(AniParms *Ap, AniPixel *Pix, const CRGB &RgbVal)
             break;
         }
         // Save this criteria and color
-        Pix->crit = currCrit;
-        Pix->color = RgbVal;
+        aniInfo.claim[PixNum].crit = AniEncodeCrit(currCrit);
+        aniInfo.claim[PixNum].epoch = aniInfo.epoch;
+        aniInfo.claim[PixNum].slot = currSlot;
+        aniInfo.color[PixNum] = RgbVal;
         numWritten++;
     }
 }
 
+/* --------------------------------------------------------------------------------------------
+ *                 ANI_GetPixel()
+ * --------------------------------------------------------------------------------------------
+ * Description:    Gets the color last written to a pixel. A higher layer may have written
+ *                 it since, check with ANI_CheckPixNum() first.
+ *
+ * Parameters:     PixNum - The pixel number
+ *
+ * Returns:        The color of the pixel. Black if PixNum is out of bounds
+ */
+CRGB ANI_GetPixel(uint32_t PixNum)
+{
+    if (PixNum >= LEDI_NUM_LEDS) {
+        return CRGB::Black;
+    }
+    if (aniInfo.direct) {
+        const LED_TYPE &led = aniInfo.drawBuff[PixNum];
+        return CRGB(led.red, led.green, led.blue);
+    }
+    return aniInfo.color[PixNum];
+}
+
+/* --------------------------------------------------------------------------------------------
+ *                 ANI_RememberPix()
+ * --------------------------------------------------------------------------------------------
+ * Description:    Puts a pixel on the pixList of an ANI_TAG_REMEMBRANCE animation so it can
+ *                 revisit it in later frames. A pixel can only be on one pixList at a time.
+ *
+ * Parameters:     Ap - Pointer to animation parameters owning the pixList
+ *                 PixNum - The pixel number
+ *
+ * Returns:        true if it was added. false if the pixel is already on a pixList or all
+ *                 ANI_REMEMBER_LINKS links are in use
+ */
+bool ANI_RememberPix(AniParms *Ap, uint32_t PixNum)
+{
+    AniPixLink *link;
+
+    if (PixNum >= LEDI_NUM_LEDS || (aniInfo.linked[PixNum >> 3] & (1 << (PixNum & 7))) ||
+        IsListEmpty(&aniInfo.freeLinks)) {
+        return false;
+    }
+
+    link = (AniPixLink*)GetHead(&aniInfo.freeLinks);
+    RemoveNode(&link->node);
+    link->pixNum = PixNum;
+    InsertTail(&Ap->pixList, &link->node);
+    aniInfo.linked[PixNum >> 3] |= (1 << (PixNum & 7));
+    return true;
+}
+
+/* --------------------------------------------------------------------------------------------
+ *                 ANI_ForgetPix()
+ * --------------------------------------------------------------------------------------------
+ * Description:    Takes a pixel off the pixList ANI_RememberPix() put it on. Safe to call
+ *                 while iterating the pixList with IterateListSafely().
+ *
+ * Parameters:     Link - The link of the pixel
+ *
+ * Returns:        void
+ */
+void ANI_ForgetPix(AniPixLink *Link)
+{
+    aniInfo.linked[Link->pixNum >> 3] &= ~(1 << (Link->pixNum & 7));
+    RemoveNode(&Link->node);
+    InsertTail(&aniInfo.freeLinks, &Link->node);
+}
+
 /* --------------------------------------------------------------------------------------------
  *                 ANI_WritePixel()
  * --------------------------------------------------------------------------------------------
@@ -511,7 +604,6 @@ void ANI_WriteVerifiedPix(AniParms *Ap, AniPixel *Pix, const CRGB &RgbVal)
  */
 void ANI_WritePixel(AniParms *Ap, uint32_t PixNum, const CRGB &RgbVal)
 {
-    AniPixel *pix;
     AniCriteria  currCrit = currAc;
 
     if (PixNum >= LEDI_NUM_LEDS) {
@@ -519,25 +611,14 @@ void ANI_WritePixel(AniParms *Ap, uint32_t PixNum, const CRGB &RgbVal)
         //PixNum = LEDI_NUM_LEDS - 1;
         return;
     }
-    pix = &aniInfo.pix[PixNum];
     //Serial.printf("owner at this pix %d is 0x%x\r\n", PixNum, aniInfo.owners[PixNum]);
 
-    if (currCrit >= pix->crit) {
+    if (aniInfo.direct) {
+        aniInfo.drawBuff[PixNum] = LED_TYPE(RgbVal);
+        numWritten++;
+    } else if (AniCanWrite(currCrit, AniPixCrit(PixNum))) {
 
         switch (currCrit) {
-        case ANI_CRIT_BELOW_LOW:
-        case ANI_CRIT_BELOW_MEDIUM:
-        case ANI_CRIT_BELOW_HIGH:
-        case ANI_CRIT_BELOW_HIGH_PERSISTENT:
-            // Only the animations being transitioned out can write to
-            // this pixel
-            if ((currCrit & ANI_CRIT_BELOW_ANY) != 0) {
-                return;
-            } else if ((currCrit == ANI_CRIT_BELOW_HIGH_PERSISTENT) && !RgbVal) {
-                currCrit = ANI_CRIT_BELOW_LOW;
-            }
-            break;
-
         case ANI_CRIT_HIGH_PERSISTENT:
         case ANI_CRIT_TRANSITION:
             if (!RgbVal) { 
@@ -546,26 +627,160 @@ void ANI_WritePixel(AniParms *Ap, uint32_t PixNum, const CRGB &RgbVal)
             break;
 
         default:
-            if (pix->crit & ANI_CRIT_BELOW_ANY) {
-                // Anything that is not a transition can't write
-                // to this pixel
-                return;
-            }
             break;
         }
         // Save this criteria and color
-        pix->crit = currCrit;
-        pix->color = RgbVal;
+        aniInfo.claim[PixNum].crit = AniEncodeCrit(currCrit);
+        aniInfo.claim[PixNum].epoch = aniInfo.epoch;
+        aniInfo.claim[PixNum].slot = currSlot;
+        aniInfo.color[PixNum] = RgbVal;
         numWritten++;
-    } else if (pix->crit == ANI_CRIT_BLEND) {
+    } else if (AniPixCrit(PixNum) == ANI_CRIT_BLEND) {
         
     }
 }
 
+/* --------------------------------------------------------------------------------------------
+ *                 ANI_WriteSpan()
+ * --------------------------------------------------------------------------------------------
+ * Description:    Same as calling ANI_WritePixel() for Count pixels in a row, but the
+ *                 permission is checked once for every run of pixels with the same criteria
+ *                 instead of once per pixel.
+ *
+ * Parameters:     Ap - Pointer to animation parameters
+ *                 PixNum - First pixel of the span
+ *                 RgbVals - Count colors, one per pixel
+ *                 Count - Number of pixels in the span. Clipped to the end of the frame
+ *
+ * Returns:        Number of pixels written
+ */
+uint16_t ANI_WriteSpan(AniParms *Ap, uint32_t PixNum, const CRGB *RgbVals, uint16_t Count)
+{
+    return AniWriteRun(PixNum, 1, RgbVals, 1, Count);
+}
+
+/* --------------------------------------------------------------------------------------------
+ *                 ANI_FillSpan()
+ * --------------------------------------------------------------------------------------------
+ * Description:    Same as ANI_WriteSpan() with every pixel of the span set to one color
+ *
+ * Parameters:     Ap - Pointer to animation parameters
+ *                 PixNum - First pixel of the span
+ *                 RgbVal - Color to write
+ *                 Count - Number of pixels in the span. Clipped to the end of the frame
+ *
+ * Returns:        Number of pixels written
+ */
+uint16_t ANI_FillSpan(AniParms *Ap, uint32_t PixNum, const CRGB &RgbVal, uint16_t Count)
+{
+    return AniWriteRun(PixNum, 1, &RgbVal, 0, Count);
+}
+
+/* --------------------------------------------------------------------------------------------
+ *                 ANI_WriteColumn()
+ * --------------------------------------------------------------------------------------------
+ * Description:    Same as ANI_WriteSpan() down a column instead of along a row. The column is
+ *                 clipped to the frame.
+ *
+ * Parameters:     Ap - Pointer to animation parameters
+ *                 X, Y - Top pixel of the column
+ *                 RgbVals - H colors, top to bottom
+ *                 H - Height of the column. Nothing is written if it is 0 or less
+ *
+ * Returns:        Number of pixels written
+ */
+uint16_t ANI_WriteColumn(AniParms *Ap, int16_t X, int16_t Y, const CRGB *RgbVals, int16_t H)
+{
+    int16_t yEnd = min((int16_t)(Y + H), (int16_t)LEDI_HEIGHT);
+
+    if (X < 0 || X >= LEDI_WIDTH) {
+        return 0;
+    }
+    if (Y < 0) {
+        RgbVals -= Y;
+        Y = 0;
+    }
+    if (Y >= yEnd) {
+        return 0;
+    }
+    return AniWriteRun(pXY(X, Y), LEDI_WIDTH, RgbVals, 1, yEnd - Y);
+}
+
+/* --------------------------------------------------------------------------------------------
+ *                 ANI_WriteRect()
+ * --------------------------------------------------------------------------------------------
+ * Description:    Fills a rectangle with one color. The rectangle is clipped to the frame and
+ *                 written a row at a time, or a column at a time when it is taller than wide,
+ *                 e.g. for the bars of a bar graph.
+ *
+ * Parameters:     Ap - Pointer to animation parameters
+ *                 X, Y - Top left corner
+ *                 W, H - Width and height. Nothing is written if either is 0 or less
+ *                 RgbVal - Color to write
+ *
+ * Returns:        Number of pixels written
+ */
+uint16_t ANI_WriteRect(AniParms *Ap, int16_t X, int16_t Y, int16_t W, int16_t H,
+                       const CRGB &RgbVal)
+{
+    int16_t  xEnd = min((int16_t)(X + W), (int16_t)LEDI_WIDTH);
+    int16_t  yEnd = min((int16_t)(Y + H), (int16_t)LEDI_HEIGHT);
+    int16_t  i;
+    uint16_t numWrite = 0;
+
+    X = max(X, (int16_t)0);
+    Y = max(Y, (int16_t)0);
+    if (X >= xEnd || Y >= yEnd) {
+        return 0;
+    }
+
+    if (xEnd - X >= yEnd - Y) {
+        for (i = Y; i < yEnd; i++) {
+            numWrite += AniWriteRun(pXY(X, i), 1, &RgbVal, 0, xEnd - X);
+        }
+    } else {
+        for (i = X; i < xEnd; i++) {
+            numWrite += AniWriteRun(pXY(i, Y), LEDI_WIDTH, &RgbVal, 0, yEnd - Y);
+        }
+    }
+    return numWrite;
+}
+
+/* --------------------------------------------------------------------------------------------
+ *                 ANI_WritableSpan()
+ * --------------------------------------------------------------------------------------------
+ * Description:    Tells which of Count pixels the current animation may write with
+ *                 ANI_WritePixel(), so an animation that is costly per pixel can skip the ones
+ *                 a higher layer already owns. Only valid for the animation being drawn by
+ *                 ANI_DrawAnimationFrame() and only before it writes to these pixels.
+ *
+ * Parameters:     PixNum - First pixel of the span
+ *                 Count - Number of pixels in the span
+ *                 Writable - Filled with Count flags. 1 if the pixel can be written, 0 if not
+ *
+ * Returns:        Number of pixels in the span that can be written
+ */
+uint16_t ANI_WritableSpan(uint32_t PixNum, uint16_t Count, uint8_t *Writable)
+{
+    uint16_t i;
+    uint16_t numWritable = 0;
+
+    for (i = 0; i < Count; i++) {
+        if (PixNum + i < LEDI_NUM_LEDS && AniCanWrite(currAc, AniPixCrit(PixNum + i))) {
+            Writable[i] = 1;
+            numWritable++;
+        } else {
+            Writable[i] = 0;
+        }
+    }
+    return numWritable;
+}
+
 /* --------------------------------------------------------------------------------------------
  *                 ANI_DrawAnimationFrame()
  * --------------------------------------------------------------------------------------------
- * Description:    Draw an animation frame funcs added earlier
+ * Description:    Draw an animation frame funcs added earlier. Every animation draws at its
+ *                 own fpsTarg, the ones that aren't due keep the pixels they drew last.
  *
  * Parameters:     drawBuff - pointer to a LED buffer to fill
  *
@@ -576,61 +791,170 @@ uint32_t ANI_DrawAnimationFrame(rgb24 *LedBuff)
 {
     uint32_t tCount;
     uint32_t now;
+    uint32_t next;
+    bool     haveNext;
+    uint16_t frameMs;
+    uint16_t held;
+    uint8_t  i;
     AniPack *aniPack;
     AniPack *aniPack2;
     
 
-    aniInfo.drawBuff = LedBuff;
     numWritten = 0;
     tCount = 0;
     now = millis();
 
     /* Sort through each animation and check if it should be */
     //Serial.println("ANI_DrawAnimationFrame: Begin");
-    if (now < aniInfo.msDelay) {
-        /* Not yet time to draw a frame */
+    if ((int32_t)(now - aniInfo.msDelay) < 0) {
+        /* No animation is due yet */
         return 0;
     }
 
-    /* Time to draw a frame! Get the next delay needed before we can draw the next frame */
-    aniInfo.msDelay = now + fps2Ms(aniInfo.fpsTarg);
+    /* Only set when drawing so it always holds the last frame drawn, see AniLeaveDirect() */
+    aniInfo.drawBuff = LedBuff;
+
+    /* Releases every pixel claimed by the last frame, except the ones of animations that
+     * aren't due. They keep what they drew until their next frame
+     */
+    AniNextEpoch();
+    held = 0;
+    IterateList(aniInfo.activeList, aniPack, AniPack*) {
+        if ((int32_t)(now - aniPack->parms.delay) < 0 && aniPack->slot != ANI_SLOT_NONE) {
+            held |= 1 << aniPack->slot;
+        }
+    }
+    for (i = 0; i < ANI_CLAIM_SLOTS; i++) {
+        if ((held & (1 << i)) == 0) {
+            aniInfo.heldEpoch[i] = aniInfo.epoch;
+        }
+    }
+
+    if (aniInfo.directCheck) {
+        aniInfo.directCheck = false;
+        /* The criteria are left alone, the pixels all read as ANI_CRIT_LOW from now on */
+        aniInfo.direct = AniCanDrawDirect();
+    }
 
+    next = now;
+    haveNext = false;
     IterateList(aniInfo.activeList, aniPack, AniPack*) {
 
         //Serial.printf("ANI_DrawAnimationFrame: criteria 0x%x. delay %lu\r\n", aniPack->currCriteria, aniPack->parms.delay);
         currAc = aniPack->currCriteria;
-        switch (currAc) {
-        case ANI_CRIT_TRANSITION:
+        currSlot = aniPack->slot;
+        if (currAc == ANI_CRIT_TRANSITION) {
             tCount++;
-            aniPack->funcp(&aniPack->parms);
+        }
+
+        if ((int32_t)(now - aniPack->parms.delay) >= 0) {
+            AniDrawTimed(aniPack);
+
+            /* Keep the cadence of the animation unless it fell a whole frame behind */
+            frameMs = aniPack->parms.fpsTarg ? fps2Ms(aniPack->parms.fpsTarg) : 0;
+            aniPack->parms.delay += frameMs;
+            if ((int32_t)(now - aniPack->parms.delay) >= 0) {
+                aniPack->parms.delay = now + frameMs;
+            }
 
             /* Check if transition is over */
             //Serial.printf("ElapsTime %lu\r\n", aniPack->parms.p.trans.transElapsTime);
-            if ((millis() - aniPack->parms.startTime) >= aniPack->parms.p.trans.transTime) {
+            if (currAc == ANI_CRIT_TRANSITION &&
+                (millis() - aniPack->parms.startTime) >= aniPack->parms.p.trans.transTime) {
                 aniPack2 = (AniPack*)GetPriorNode(&aniPack->node);
                 AniSetInactive(aniPack);
                 aniPack = aniPack2;
                 tCount--;
+                continue;
             }
-            break;
+        }
 
-        default:
-            aniPack->funcp(&aniPack->parms);
-            break;
+        /* The earliest deadline is when the next frame is drawn */
+        if (!haveNext || (int32_t)(aniPack->parms.delay - next) < 0) {
+            next = aniPack->parms.delay;
+            haveNext = true;
         }
     }
+    aniInfo.msDelay = next;
 
     if (aniInfo.tranInProg && tCount == 0) {
         AniTransDone();
     }
 
     if (numWritten > 0) {
-        AniWriteToBuffer();
+        if (!aniInfo.direct) {
+            AniWriteToBuffer();
+        }
         return LEDI_NUM_LEDS;
     }
     return 0;
 }
 
+/* --------------------------------------------------------------------------------------------
+ *                 ANI_MsToNextFrame()
+ * --------------------------------------------------------------------------------------------
+ * Description:    Gets how long until the earliest active animation is due. Until then
+ *                 ANI_DrawAnimationFrame() has nothing to draw, so the caller can sleep.
+ *
+ * Parameters:     None
+ *
+ * Returns:        Time in ms. 0 if an animation is due now
+ */
+uint32_t ANI_MsToNextFrame(void)
+{
+    int32_t ms = (int32_t)(aniInfo.msDelay - millis());
+
+    return ms > 0 ? ms : 0;
+}
+
+/* --------------------------------------------------------------------------------------------
+ *                 ANI_ReportRenderTimes()
+ * --------------------------------------------------------------------------------------------
+ * Description:    Prints the min, mean, p99 and max render time of every registered animation
+ *                 that has drawn at least one frame, active or not. Animations are listed by
+ *                 their function address, the same way MtxMgr lists them when registering.
+ *                 Each one is held to the frame budget of its own fpsTarg, and shown with
+ *                 the quality level it adapted to, if it adapts.
+ *                 The p99 is the upper edge of its histogram bucket, so it is within a quarter
+ *                 of an octave above the real value.
+ *
+ * Parameters:     None
+ *
+ * Returns:        void
+ */
+void ANI_ReportRenderTimes(void)
+{
+    Serial.printf("Render times in us\n\r");
+    AniReportTimes(&aniInfo.activeList);
+    AniReportTimes(&aniInfo.queueList);
+    AniReportTimes(&aniInfo.mainWaitList);
+    AniReportTimes(&aniInfo.transWaitList);
+}
+
+/* --------------------------------------------------------------------------------------------
+ *                 ANI_ResetRenderTimes()
+ * --------------------------------------------------------------------------------------------
+ * Description:    Clears the render times of every registered animation, e.g. to measure a
+ *                 new set of parms from scratch.
+ *
+ * Parameters:     None
+ *
+ * Returns:        void
+ */
+void ANI_ResetRenderTimes(void)
+{
+    ListNode *lists[] = {&aniInfo.activeList, &aniInfo.queueList,
+                         &aniInfo.mainWaitList, &aniInfo.transWaitList};
+    AniPack  *aniPack;
+    uint8_t   i;
+
+    for (i = 0; i < sizeof(lists) / sizeof(lists[0]); i++) {
+        IterateList(*lists[i], aniPack, AniPack *) {
+            AniClearTimes(&aniPack->times);
+        }
+    }
+}
+
 #if 0
 /* --------------------------------------------------------------------------------------------
  *                 ANIFUNC_FillNoise8()
@@ -774,38 +1098,35 @@ uint8_t const exp_gamma[256] =
  */
 void ANIFUNC_PlazInt(AniParms *Ap)
 {
-    uint16_t x, y;
     uint16_t t;
     uint16_t t2;
     uint16_t t3;
-    CRGB led;
-    AniPixel *currAniPix;
 
     Ap->counter++;
     t  = cubicwave8((33 * Ap->counter)/100); // time displacement
     t2 = cubicwave8((8 * Ap->counter)/100); // fiddle with these
     t3 = cubicwave8((15 * Ap->counter)/100); // to change looks
-    for (x = 0; x < LEDI_WIDTH; x++) {
-        for (y = 0; y < LEDI_HEIGHT; y++) {
-            if ((currAniPix = ANI_CheckPixNum(pXY(x, y))) != 0) {
-                //Calculate 3 seperate plasma waves, one for each color channel
-                led.r = cubicwave8(((x << 3) + (t >> 1) +
-                        cubicwave8((t2 + (y << 3)))));
-                led.g = cubicwave8(((y << 3) + t +
-                        cubicwave8(((t3 >> 2) + (x << 3)))));
-                led.b = triwave8(((y << 3) + t2 +
-                        triwave8((t + x + (led.g >> 2)))));
+    ANI_ForEachPixel(LEDI_WIDTH, 1, [&](uint16_t x, uint16_t y, uint32_t pixNum) {
+        CRGB led;
+
+        if (ANI_CheckPixNum(pixNum)) {
+            //Calculate 3 seperate plasma waves, one for each color channel
+            led.r = cubicwave8(((x << 3) + (t >> 1) +
+                    cubicwave8((t2 + (y << 3)))));
+            led.g = cubicwave8(((y << 3) + t +
+                    cubicwave8(((t3 >> 2) + (x << 3)))));
+            led.b = triwave8(((y << 3) + t2 +
+                    triwave8((t + x + (led.g >> 2)))));
 #if 1 /* Faster, more memory */
-                led.b = exp_gamma[led.b];
-                led.g = exp_gamma[led.g];
-                led.r = exp_gamma[led.r];
+            led.b = exp_gamma[led.b];
+            led.g = exp_gamma[led.g];
+            led.r = exp_gamma[led.r];
 #else
-                led = applyGamma_video(led, 2.1);
+            led = applyGamma_video(led, 2.1);
 #endif
-                ANI_WriteVerifiedPix(Ap, currAniPix, led);
-            }
+            ANI_WriteVerifiedPix(Ap, pixNum, led);
         }
-    }
+    });
 }
 
 /* --------------------------------------------------------------------------------------------
@@ -820,27 +1141,33 @@ void ANIFUNC_PlazInt(AniParms *Ap)
 void ANIFUNC_RainbowIris(AniParms *Ap)
 {
     // FastLED's built-in rainbow generator
-    CHSV   hsvX, hsvY;
-    CRGB   crgb;
+    CHSV   hsvY;
+    CRGB   row[LEDI_WIDTH];
+    uint8_t hue[LEDI_WIDTH / 2];
+    uint8_t step[LEDI_WIDTH / 2];
     uint16_t x, y;
     uint16_t scale = Ap->scale;
 
-    hsvX = Ap->hsv;
-    hsvY = hsvX;
+    /* Every column steps its hue down the rows by its own amount */
     for (x = 0; x < LEDI_WIDTH / 2; x++) {
         if ((x % 3) == 0) {
             scale++;
         }
-        //hsvX.h += scale >> 2;
-        hsvY = hsvX;
-        for (y = 0; y < LEDI_HEIGHT / 2; y++) {
-            hsvY.h += scale >> 1;
-            crgb = hsvY;
-            ANI_WritePixel(Ap, pXY(x, y), crgb);
-            ANI_WritePixel(Ap, pXY(x, LEDI_HEIGHT - 1 - y), crgb);
-            ANI_WritePixel(Ap, pXY(LEDI_WIDTH - 1 - x, y), crgb);
-            ANI_WritePixel(Ap, pXY(LEDI_WIDTH - 1 - x, LEDI_HEIGHT - 1 - y), crgb);
+        hue[x] = Ap->hsv.h;
+        step[x] = scale >> 1;
+    }
+
+    /* Build the top rows mirrored left to right and write each to its mirrored bottom row */
+    hsvY = Ap->hsv;
+    for (y = 0; y < LEDI_HEIGHT / 2; y++) {
+        for (x = 0; x < LEDI_WIDTH / 2; x++) {
+            hue[x] += step[x];
+            hsvY.h = hue[x];
+            row[x] = hsvY;
+            row[LEDI_WIDTH - 1 - x] = row[x];
         }
+        ANI_WriteSpan(Ap, pXY(0, y), row, LEDI_WIDTH);
+        ANI_WriteSpan(Ap, pXY(0, LEDI_HEIGHT - 1 - y), row, LEDI_WIDTH);
     }
 
     Ap->hsv.h += Ap->speed;
@@ -861,39 +1188,40 @@ void ANIFUNC_RainbowIris(AniParms *Ap)
  */
 void ANIFUNC_Confetti(AniParms *Ap)
 {
-    AniPixel *currAniPix;
-    AniPixel *nextAniPix;
+    AniPixLink *currLink;
+    AniPixLink *nextLink;
+    uint32_t    pixNum;
     CRGB crgb;
     
     //Serial.println("ANIFUNC_Confetti 1");
     // Random colored speckles that blink in and fade smoothly
-    IterateListSafely(Ap->pixList, currAniPix, nextAniPix, AniPixel*) {
+    IterateListSafely(Ap->pixList, currLink, nextLink, AniPixLink*) {
         // Wrote to this in the past. Check if we still can
-        if (ANI_CheckPix(currAniPix)) {
-            crgb = currAniPix->color;
+        if (ANI_CheckPixNum(currLink->pixNum)) {
+            crgb = ANI_GetPixel(currLink->pixNum);
             //Serial.printf("Before crgb r,b,g (%d,%d,%d)\r\n", crgb.r, crgb.b, crgb.g);
             crgb.nscale8(Ap->scale);
             //Serial.printf("After crgb r,b,g (%d,%d,%d)\r\n", crgb.r, crgb.b, crgb.g);
-            ANI_WriteVerifiedPix(Ap, currAniPix, crgb);
+            ANI_WriteVerifiedPix(Ap, currLink->pixNum, crgb);
             if (!crgb) {
                 // Pixel faded to black, so remove from list */
-                RemoveNode(&currAniPix->node);
+                ANI_ForgetPix(currLink);
             }
         } else {
             // A higher layer animation wrote to this pixel. Since we lost the color
             // value we wrote, we will just remove this from the list now.
-            RemoveNode(&currAniPix->node);
+            ANI_ForgetPix(currLink);
         }
     }
     //Serial.println("ANIFUNC_Confetti 2");
-    if ((currAniPix = ANI_CheckPixNum(random16(LEDI_NUM_LEDS))) != 0) {
-        // Make sure this pixel is not already on a list. Adding it to a list
-        // (whether its the same list or different one), will corrupt the previous list.
-        if (!IsNodeUsed(&currAniPix->node)) {
+    pixNum = random16(LEDI_NUM_LEDS);
+    if (ANI_CheckPixNum(pixNum)) {
+        // A pixel can only be on one list. ANI_RememberPix() fails if it already is on this
+        // one or another one.
+        if (ANI_RememberPix(Ap, pixNum)) {
             crgb.setHue(Ap->hsv.hue + random8(64));
             //Serial.println("ANIFUNC_Confetti 2.2");
-            ANI_WriteVerifiedPix(Ap, currAniPix, crgb);
-            InsertTail(&Ap->pixList, &currAniPix->node);
+            ANI_WriteVerifiedPix(Ap, pixNum, crgb);
         }
     }
 
@@ -939,25 +1267,154 @@ void juggle()
 /* --------------------------------------------------------------------------------------------
  *                 AniWriteToBuffer()
  * --------------------------------------------------------------------------------------------
- * Description:   TODO this can be improved if we swap between two different lists. Items on
- *                list are pixels that haven't been drawn yet. 
+ * Description:    Copies the color plane to drawBuff. The criteria need no clean up, the
+ *                 next frame gets a new epoch and that releases them.
  *
- * Parameters:     
+ * Parameters:     None
  *
- * Returns:        
+ * Returns:        void
  */
 void AniWriteToBuffer(void)
 {
     uint16_t i;
+
+    if (sizeof(LED_TYPE) == sizeof(CRGB)) {
+        /* rgb24 and CRGB are both 3 bytes of red, green and blue */
+        memcpy((void*)aniInfo.drawBuff, (const void*)aniInfo.color, sizeof(CRGB) * LEDI_NUM_LEDS);
+    } else {
+        for (i = 0; i < LEDI_NUM_LEDS; i++) {
+            aniInfo.drawBuff[i] = LED_TYPE(aniInfo.color[i]);
+        }
+    }
+}
+
+/* --------------------------------------------------------------------------------------------
+ *                 AniCanWrite()
+ * --------------------------------------------------------------------------------------------
+ * Description:    Checks if an animation of criteria Crit may write to the pixel. Animations
+ *                 being transitioned out (the BELOW criteria) can't write at all and the
+ *                 regular ones can't write to pixels held by an animation being transitioned
+ *                 out.
+ *
+ * Parameters:     Crit - Criteria of the writing animation
+ *                 PixCrit - Criteria of the pixel to write
+ *
+ * Returns:        true if the pixel can be written, false otherwise
+ */
+bool AniCanWrite(AniCriteria Crit, AniCriteria PixCrit)
+{
+    if (Crit < PixCrit) {
+        return false;
+    }
+
+    switch (Crit) {
+    case ANI_CRIT_BELOW_LOW:
+    case ANI_CRIT_BELOW_MEDIUM:
+    case ANI_CRIT_BELOW_HIGH:
+    case ANI_CRIT_BELOW_HIGH_PERSISTENT:
+        return false;
+
+    case ANI_CRIT_HIGH_PERSISTENT:
+    case ANI_CRIT_TRANSITION:
+        return true;
+
+    default:
+        return (PixCrit & ANI_CRIT_BELOW_ANY) == 0;
+    }
+}
+
+/* --------------------------------------------------------------------------------------------
+ *                 AniPixCrit()
+ * --------------------------------------------------------------------------------------------
+ * Description:    Gets the criteria of a pixel. A criteria written this frame holds as is.
+ *                 One written in an earlier frame is released to ANI_CRIT_LOW, or to
+ *                 ANI_CRIT_BELOW_LOW if it belongs to an animation being transitioned out.
+ *                 Persistent ones are kept and so are the ones of an animation that isn't
+ *                 due this frame. Pixels not written since baseEpoch have baseCrit.
+ *
+ * Parameters:     PixNum - The pixel number. Must be in bounds
+ *
+ * Returns:        The criteria of the pixel
+ */
+AniCriteria AniPixCrit(uint32_t PixNum)
+{
+    AniCriteria crit = aniCritOf[aniInfo.claim[PixNum].crit];
+    AniEpoch    age = aniInfo.epoch - aniInfo.claim[PixNum].epoch;
+    uint8_t     slot = aniInfo.claim[PixNum].slot;
+
+    if (age == 0) {
+        return crit;
+    }
+    if (age > (AniEpoch)(aniInfo.epoch - aniInfo.baseEpoch)) {
+        return aniInfo.baseCrit;
+    }
+    if ((crit & ANI_CRIT_PERSISTENT) || (crit & (ANI_CRIT_BELOW_ANY | ANI_CRIT_ACTIVE_ANY)) == 0) {
+        return crit;
+    }
+    if (slot != ANI_SLOT_NONE && age <= (AniEpoch)(aniInfo.epoch - aniInfo.heldEpoch[slot])) {
+        /* Its animation isn't due. Like a persistent pixel, nothing else on its layer can
+         * write it
+         */
+        return crit | ANI_CRIT_PERSISTENT;
+    }
+    if (crit & ANI_CRIT_BELOW_ANY) {
+        return ANI_CRIT_BELOW_LOW;
+    }
+    return ANI_CRIT_LOW;
+}
+
+/* --------------------------------------------------------------------------------------------
+ *                 AniEncodeCrit()
+ * --------------------------------------------------------------------------------------------
+ * Description:    Gets the AniCritCode a criteria is stored in a claim as. aniCritOf[] turns
+ *                 it back.
+ *
+ * Parameters:     Crit - Criteria with at most one bit set besides ANI_CRIT_PERSISTENT
+ *
+ * Returns:        The code of the criteria
+ */
+AniCritCode AniEncodeCrit(AniCriteria Crit)
+{
+    uint32_t high = Crit & ~ANI_CRIT_PERSISTENT;
+
+    return (AniCritCode)(((high ? 28 - __builtin_clz(high) : 0) << 1) |
+                         (Crit & ANI_CRIT_PERSISTENT));
+}
+
+/* --------------------------------------------------------------------------------------------
+ *                 AniNextEpoch()
+ * --------------------------------------------------------------------------------------------
+ * Description:    Starts the epoch of a new frame, which releases the pixels claimed in the
+ *                 last one. Every ANI_EPOCH_REBASE frames the criteria of every pixel are
+ *                 written back with their current value, so no age can wrap around and look
+ *                 recent again.
+ *
+ * Parameters:     None
+ *
+ * Returns:        void
+ */
+void AniNextEpoch(void)
+{
+    AniCriteria crit;
+    uint16_t    i;
+
+    aniInfo.epoch++;
+    if ((aniInfo.epoch & (ANI_EPOCH_REBASE - 1)) != 0) {
+        return;
+    }
+
     for (i = 0; i < LEDI_NUM_LEDS; i++) {
-        aniInfo.drawBuff[i] = LED_TYPE(aniInfo.pix[i].color);
-        if ((aniInfo.pix[i].crit & ANI_CRIT_PERSISTENT) == 0) {
-            if (aniInfo.pix[i].crit & ANI_CRIT_BELOW_ANY) {
-                aniInfo.pix[i].crit = ANI_CRIT_BELOW_LOW;
-            } else if (aniInfo.pix[i].crit & ANI_CRIT_ACTIVE_ANY) {
-                aniInfo.pix[i].crit = ANI_CRIT_LOW;
-            }
+        crit = AniPixCrit(i);
+        if ((crit ^ aniCritOf[aniInfo.claim[i].crit]) != ANI_CRIT_PERSISTENT) {
+            /* Not held by its animation, only the criteria is left to keep */
+            aniInfo.claim[i].crit = AniEncodeCrit(crit);
+            aniInfo.claim[i].slot = ANI_SLOT_NONE;
         }
+        aniInfo.claim[i].epoch = aniInfo.epoch - 1;
+    }
+    aniInfo.baseEpoch = aniInfo.epoch - 1;
+    for (i = 0; i < ANI_CLAIM_SLOTS; i++) {
+        aniInfo.heldEpoch[i] = aniInfo.epoch - 1;
     }
 }
 
@@ -972,15 +1429,27 @@ void AniWriteToBuffer(void)
  */
 void AniSetInactive(AniPack *Ap)
 {
-    ListNode   *node;
+    AniLeaveDirect();
 
     // Remove animation from the active list
     RemoveNode(&Ap->node);
 
+    // Give up its slot, the pixels it still holds are released with the next frame
+    if (Ap->slot != ANI_SLOT_NONE) {
+        aniInfo.slotsUsed &= ~(1 << Ap->slot);
+        Ap->slot = ANI_SLOT_NONE;
+    }
+
     // Remove any held pixels if there are any
     while(!IsListEmpty(&Ap->parms.pixList)) {
-        node = GetHead(&Ap->parms.pixList);
-        RemoveNode(node);
+        ANI_ForgetPix((AniPixLink*)GetHead(&Ap->parms.pixList));
+    }
+
+    // Let it free what it allocated for its frames, it draws nothing
+    if (Ap->tags & ANI_TAG_WARMUP) {
+        Ap->parms.cooldown = true;
+        Ap->funcp(&Ap->parms);
+        Ap->parms.cooldown = false;
     }
 
     if (Ap->defaultLayer & (ANI_LAYER_TRANSITION)) {
@@ -1009,6 +1478,7 @@ void AniTransDone()
     ListNode *nodeItr;
 
     aniInfo.tranInProg = false;
+    aniInfo.directCheck = true;
 
     Serial.println("In AniTransDone");
 
@@ -1020,4 +1490,315 @@ void AniTransDone()
             AniSetInactive(aniPack);
         }
     }
-}
\ No newline at end of file
+}
+
+/* --------------------------------------------------------------------------------------------
+ *                 AniWriteRun()
+ * --------------------------------------------------------------------------------------------
+ * Description:    Writes the pixels of a span the current animation has permission to, with
+ *                 the same rules as ANI_WritePixel(). The span is split into runs of pixels
+ *                 last written with the same criteria in the same frame and the permission is
+ *                 checked once per run.
+ *
+ * Parameters:     PixNum - First pixel of the span
+ *                 Stride - Distance between two pixels of the span. 1 for a row, LEDI_WIDTH
+ *                     for a column
+ *                 RgbVals - Colors to write
+ *                 Step - 1 to write RgbVals[i] to pixel i, 0 to write RgbVals[0] to all
+ *                 Count - Number of pixels in the span. Clipped to the end of the frame
+ *
+ * Returns:        Number of pixels written
+ */
+uint16_t AniWriteRun(uint32_t PixNum, uint16_t Stride, const CRGB *RgbVals, uint8_t Step,
+                     uint16_t Count)
+{
+    AniClaim    *claim;
+    CRGB        *color;
+    AniClaim     run;
+    AniEpoch     epoch = aniInfo.epoch;
+    AniCriteria  blackCrit = currAc;
+    AniCritCode  currCode, blackCode;
+    uint16_t     numWrite = 0;
+    uint16_t     i, j, end;
+
+    if (Count == 0) {
+        return 0;
+    }
+    if (PixNum + (uint32_t)(Count - 1) * Stride >= LEDI_NUM_LEDS) {
+        Serial.println("Overbounds!");
+        if (PixNum >= LEDI_NUM_LEDS) {
+            return 0;
+        }
+        Count = (LEDI_NUM_LEDS - 1 - PixNum) / Stride + 1;
+    }
+
+    if (aniInfo.direct) {
+        LED_TYPE *buff = &aniInfo.drawBuff[PixNum];
+
+        for (i = 0; i < Count; i++) {
+            buff[i * Stride] = LED_TYPE(RgbVals[i * Step]);
+        }
+        numWritten += Count;
+        return Count;
+    }
+
+    /* Black written by these releases the pixel, see ANI_WritePixel() */
+    if (currAc == ANI_CRIT_HIGH_PERSISTENT || currAc == ANI_CRIT_TRANSITION) {
+        blackCrit = ANI_CRIT_LOW;
+    }
+
+    currCode = AniEncodeCrit(currAc);
+    blackCode = AniEncodeCrit(blackCrit);
+
+    claim = &aniInfo.claim[PixNum];
+    color = &aniInfo.color[PixNum];
+    for (i = 0; i < Count; i = end) {
+        /* Pixels with the same claim have the same criteria */
+        run = claim[i * Stride];
+        for (end = i + 1; end < Count && claim[end * Stride].crit == run.crit &&
+                          claim[end * Stride].epoch == run.epoch &&
+                          claim[end * Stride].slot == run.slot; end++) {
+        }
+        if (!AniCanWrite(currAc, AniPixCrit(PixNum + i * Stride))) {
+            continue;
+        }
+
+        for (j = i; j < end; j++) {
+            const CRGB &rgb = RgbVals[j * Step];
+
+            color[j * Stride] = rgb;
+            claim[j * Stride].crit = rgb ? currCode : blackCode;
+            claim[j * Stride].epoch = epoch;
+            claim[j * Stride].slot = currSlot;
+        }
+        numWrite += end - i;
+    }
+
+    numWritten += numWrite;
+    return numWrite;
+}
+
+/* --------------------------------------------------------------------------------------------
+ *                 AniDrawTimed()
+ * --------------------------------------------------------------------------------------------
+ * Description:    Calls the animation function and adds its render time to the histogram
+ *
+ * Parameters:     Ap - The animation to draw
+ *
+ * Returns:        void
+ */
+void AniDrawTimed(AniPack *Ap)
+{
+    AniTimes *times = &Ap->times;
+    uint32_t  start;
+    uint32_t  us;
+    uint8_t   bucket;
+    uint8_t   i;
+
+    start = micros();
+    Ap->funcp(&Ap->parms);
+    us = micros() - start;
+
+    bucket = AniTimeBucket(us);
+    if (times->bucket[bucket] == UINT16_MAX) {
+        /* Keep the shape of the histogram, the percentiles don't change */
+        for (i = 0; i < ANI_TIME_BUCKETS; i++) {
+            times->bucket[i] >>= 1;
+        }
+    }
+    times->bucket[bucket]++;
+
+    if (times->count == 0 || us < times->minUs) {
+        times->minUs = us;
+    }
+    if (us > times->maxUs) {
+        times->maxUs = us;
+    }
+    times->sumUs += us;
+    times->count++;
+}
+
+/* --------------------------------------------------------------------------------------------
+ *                 AniClearTimes()
+ * --------------------------------------------------------------------------------------------
+ * Description:    Clears render times
+ *
+ * Parameters:     Times - Render times to clear
+ *
+ * Returns:        void
+ */
+void AniClearTimes(AniTimes *Times)
+{
+    memset(Times, 0, sizeof(*Times));
+}
+
+/* --------------------------------------------------------------------------------------------
+ *                 AniTimeBucket()
+ * --------------------------------------------------------------------------------------------
+ * Description:    Gets the histogram bucket of a render time. Times below 4us get a bucket
+ *                 each, above that every octave is split into 4 buckets.
+ *
+ * Parameters:     Us - Render time in us
+ *
+ * Returns:        Bucket index, clamped to the last bucket
+ */
+uint8_t AniTimeBucket(uint32_t Us)
+{
+    uint32_t log2;
+    uint32_t bucket;
+
+    if (Us < 4) {
+        return (uint8_t)Us;
+    }
+    log2 = 31 - __builtin_clz(Us);
+    bucket = ((log2 - 1) << 2) | ((Us >> (log2 - 2)) & 3);
+    return (uint8_t)min(bucket, (uint32_t)(ANI_TIME_BUCKETS - 1));
+}
+
+/* --------------------------------------------------------------------------------------------
+ *                 AniBucketUs()
+ * --------------------------------------------------------------------------------------------
+ * Description:    Gets the shortest render time that lands in a bucket. Inverse of
+ *                 AniTimeBucket().
+ *
+ * Parameters:     Bucket - Bucket index
+ *
+ * Returns:        Render time in us
+ */
+uint32_t AniBucketUs(uint8_t Bucket)
+{
+    if (Bucket < 4) {
+        return Bucket;
+    }
+    return (uint32_t)(4 | (Bucket & 3)) << ((Bucket >> 2) - 1);
+}
+
+/* --------------------------------------------------------------------------------------------
+ *                 AniReportTimes()
+ * --------------------------------------------------------------------------------------------
+ * Description:    Prints the render times and quality level of the animations on a list.
+ *                 Animations whose p99 doesn't fit the frame budget of their fpsTarg are
+ *                 flagged.
+ *
+ * Parameters:     List - List of AniPack
+ *
+ * Returns:        void
+ */
+void AniReportTimes(ListNode *List)
+{
+    AniPack  *aniPack;
+    AniTimes *times;
+    uint32_t  budgetUs;
+    uint32_t  total;
+    uint32_t  seen;
+    uint32_t  p99;
+    uint8_t   i;
+
+    IterateList(*List, aniPack, AniPack *) {
+        times = &aniPack->times;
+        if (times->count == 0) {
+            continue;
+        }
+
+        total = 0;
+        for (i = 0; i < ANI_TIME_BUCKETS; i++) {
+            total += times->bucket[i];
+        }
+
+        /* First bucket that holds 99% of the frames */
+        seen = 0;
+        for (i = 0; i < ANI_TIME_BUCKETS - 1; i++) {
+            seen += times->bucket[i];
+            if (seen * 100 >= total * 99) {
+                break;
+            }
+        }
+        p99 = times->maxUs;
+        if (i < ANI_TIME_BUCKETS - 1) {
+            p99 = min(AniBucketUs(i + 1) - 1, times->maxUs);
+        }
+
+        /* 0 if it has no frame rate to keep up with */
+        budgetUs = aniPack->parms.fpsTarg ? 1000000 / aniPack->parms.fpsTarg : 0;
+
+        Serial.printf("func 0x%08lx  frames %8lu  min %6lu  mean %6lu  p99 %6lu  max %6lu"
+                      "  budget %6lu  level %u%s\n\r",
+                      (unsigned long)(uintptr_t)aniPack->funcp, times->count, times->minUs,
+                      (uint32_t)(times->sumUs / times->count), p99, times->maxUs, budgetUs,
+                      aniPack->parms.level,
+                      (budgetUs != 0 && p99 > budgetUs) ? "  over budget" : "");
+    }
+}
+
+/* --------------------------------------------------------------------------------------------
+ *                 AniCanDrawDirect()
+ * --------------------------------------------------------------------------------------------
+ * Description:    Checks if the active animations can skip the color and criteria planes and
+ *                 write straight into drawBuff. This is the case when a single ANI_TAG_OPAQUE
+ *                 animation on a regular layer plays, no transition is in progress and every
+ *                 pixel is writable to it. The frame it draws is then the same either way.
+ *                 ANI_TAG_REMEMBRANCE animations read back their pixels, so they are left on
+ *                 the planes.
+ *
+ * Parameters:     None
+ *
+ * Returns:        true if the active animation can write to drawBuff, false otherwise
+ */
+bool AniCanDrawDirect(void)
+{
+    AniPack *aniPack;
+    uint16_t i;
+
+    if (sizeof(LED_TYPE) != sizeof(CRGB) || aniInfo.tranInProg ||
+        IsListEmpty(&aniInfo.activeList)) {
+        return false;
+    }
+
+    aniPack = (AniPack*)GetHead(&aniInfo.activeList);
+    if (GetNextNode(&aniPack->node) != &aniInfo.activeList) {
+        /* More than one animation */
+        return false;
+    }
+    if ((aniPack->tags & (ANI_TAG_OPAQUE | ANI_TAG_REMEMBRANCE)) != ANI_TAG_OPAQUE) {
+        return false;
+    }
+
+    switch (aniPack->currCriteria) {
+    case ANI_CRIT_LOW:
+    case ANI_CRIT_MEDIUM:
+    case ANI_CRIT_HIGH:
+        break;
+
+    default:
+        return false;
+    }
+
+    /* A pixel can still be held, e.g. by a persistent animation that was swapped out */
+    for (i = 0; i < LEDI_NUM_LEDS; i++) {
+        if (!AniCanWrite(aniPack->currCriteria, AniPixCrit(i))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/* --------------------------------------------------------------------------------------------
+ *                 AniLeaveDirect()
+ * --------------------------------------------------------------------------------------------
+ * Description:    Called before the active animations change. Goes back to drawing through
+ *                 the color and criteria planes, the next frame checks again if it can write
+ *                 straight to drawBuff. The last frame drawn is copied to the color plane
+ *                 since transitions and pixels nobody writes show what it holds.
+ *
+ * Parameters:     None
+ *
+ * Returns:        void
+ */
+void AniLeaveDirect(void)
+{
+    if (aniInfo.direct) {
+        memcpy((void*)aniInfo.color, (const void*)aniInfo.drawBuff, sizeof(CRGB) * LEDI_NUM_LEDS);
+        aniInfo.direct = false;
+    }
+    aniInfo.directCheck = true;
+}
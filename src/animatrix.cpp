@@ -18,1154 +18,2681 @@
  *  MACROS
  * --------------------------------------------------------------------------------------------
  */
-#define NOISE_FADE(t) ((t) * (t) * (t) * ((t) * ((t) * 6 - 15) + 10))
-#define NOISE_LERP(t, a, b) ((a) + (t) * ((b) - (a)))
 /* --------------------------------------------------------------------------------------------
  * NUM_OSCILLATORS define
  *
  * 
  */
 #define NUM_OSCILLATORS 10
+
+/* --------------------------------------------------------------------------------------------
+ * ANIMAX_CENTER_X/Y define
+ *
+ * Center of the matrix the polar coordinates are taken around
+ */
+#define ANIMAX_CENTER_X ((LEDI_WIDTH / 2) - 0.5)
+#define ANIMAX_CENTER_Y ((LEDI_HEIGHT / 2) - 0.5)
+
+/* --------------------------------------------------------------------------------------------
+ * ANIMAX_RENDER_CHUNK define
+ *
+ * Number of samples AnimaxRenderLayerT() hands to the batched noise kernel at once. Sets the
+ * size of the scratch arrays it keeps on the stack.
+ */
+#define ANIMAX_RENDER_CHUNK 64
+
+/* --------------------------------------------------------------------------------------------
+ * ANIMAX_TILE_WIDTH / ANIMAX_TILE_HEIGHT define
+ *
+ * How the animations walk their sample grid with AnimaxForEachSpan(). Every span is rendered
+ * with one batch per layer, so full rows give the longest batches. Use ANI_TILE_WIDTH and
+ * ANI_TILE_HEIGHT for cache sized tiles instead. Tiles are clipped to the grid, which is
+ * smaller than the frame at reduced AnimaxQuality.
+ */
+#ifndef ANIMAX_TILE_WIDTH
+#define ANIMAX_TILE_WIDTH LEDI_WIDTH
+#endif /* ANIMAX_TILE_WIDTH */
+
+#ifndef ANIMAX_TILE_HEIGHT
+#define ANIMAX_TILE_HEIGHT 1
+#endif /* ANIMAX_TILE_HEIGHT */
+
+/* --------------------------------------------------------------------------------------------
+ * ANIMAX_GRID_DIM define
+ *
+ * Number of samples along an edge of N pixels at AnimaxQuality Q
+ */
+#define ANIMAX_GRID_DIM(N, Q) (((N) + (1 << (Q)) - 1) >> (Q))
+
+/* --------------------------------------------------------------------------------------------
+ * ANIMAX_DIST_FRAC_BITS define
+ *
+ * Fraction bits of the fixed point distances in the polar tables. 8 leaves room for
+ * distances up to 255 pixels, which covers chained panels of 256 x 128 and more.
+ */
+#ifndef ANIMAX_DIST_FRAC_BITS
+#define ANIMAX_DIST_FRAC_BITS 8
+#endif /* ANIMAX_DIST_FRAC_BITS */
+
+/* --------------------------------------------------------------------------------------------
+ * ANIMAX_DIST_LSB / ANIMAX_ANGLE_LSB / ANIMAX_UNIT_LSB define
+ *
+ * Value of one step of the uint16 entries of the polar tables. Distances are fixed point,
+ * angles span 0 to PI / 2 and cosines and sines 0 to 1.
+ */
+#define ANIMAX_DIST_LSB     (1.0 / (1 << ANIMAX_DIST_FRAC_BITS))
+#define ANIMAX_ANGLE_LSB    ((PI / 2) / 65535)
+#define ANIMAX_UNIT_LSB     (1.0 / 65535)
+
+/* --------------------------------------------------------------------------------------------
+ * ANIMAX_MAX_LAYERS define
+ *
+ * Most noise layers an AnimaxDesc can stack
+ */
+#define ANIMAX_MAX_LAYERS 4
+
+/* --------------------------------------------------------------------------------------------
+ * ANIMAX_DEFAULT_OFFSETS / ANIMAX_DEFAULT_RATIOS define
+ *
+ * Oscillator time offsets and speed ratios animations start from
+ */
+#define ANIMAX_DEFAULT_OFFSETS {0, 100, 200, 300, 400, 500, 600, 700, 800, 900}
+#define ANIMAX_DEFAULT_RATIOS  {1, 2, 3, 4, 5, 6, 7, 8, 9, 10}
+
+/* --------------------------------------------------------------------------------------------
+ * ANIMAX_K / ANIMAX_M / ANIMAX_KM / ANIMAX_MM define
+ *
+ * AnimaxBind initializers. A constant, K times a modulator, a constant plus K times a
+ * modulator and K times the product of two modulators.
+ */
+#define ANIMAX_K(BASE)           {BASE, 0, ANIMAX_ONE, ANIMAX_ONE}
+#define ANIMAX_M(K, A)           {0, K, A, ANIMAX_ONE}
+#define ANIMAX_KM(BASE, K, A)    {BASE, K, A, ANIMAX_ONE}
+#define ANIMAX_MM(K, A, B)       {0, K, A, B}
+
+/* --------------------------------------------------------------------------------------------
+ * ANIMAX_FEED / ANIMAX_NO_FEED / ANIMAX_NO_FEEDS define
+ *
+ * AnimaxFeed initializers. ANIMAX_NO_FEEDS fills all feeds of a layer.
+ */
+#define ANIMAX_FEED(LAYER, K)    {LAYER, K}
+#define ANIMAX_NO_FEED           {-1, 0}
+#define ANIMAX_NO_FEEDS          {ANIMAX_NO_FEED, ANIMAX_NO_FEED, ANIMAX_NO_FEED, ANIMAX_NO_FEED}
+
+/* --------------------------------------------------------------------------------------------
+ * ANIMAX_CH / ANIMAX_CH_PROD define
+ *
+ * AnimaxChannel initializers. A weighted sum of the layers, or K times the product of two
+ * layers. MASKS are ANIMAX_MASK_* flags.
+ */
+#define ANIMAX_CH(K0, K1, K2, K3, MASKS)  {{K0, K1, K2, K3}, 0, 0, 0, MASKS}
+#define ANIMAX_CH_PROD(K, A, B, MASKS)    {{0, 0, 0, 0}, K, A, B, MASKS}
+
+/* --------------------------------------------------------------------------------------------
+ * ANIMAX_MASK_* define
+ *
+ * Per sample factors a colormap channel can be multiplied by. d is the distance of the
+ * sample from the center and y its row.
+ */
+#define ANIMAX_MASK_FADE    0x01    /* (radius - d) / radius */
+#define ANIMAX_MASK_BLOB    0x02    /* (radius - d) / d */
+#define ANIMAX_MASK_ROW     0x04    /* (y + rowBias) / rowDiv */
+#define ANIMAX_MASK_DIST    0x08    /* d */
+
+/* --------------------------------------------------------------------------------------------
+ * ANIMAX_MODE_* define
+ *
+ * How AnimaxRenderLayerT() gets the angle of a sample. PLANES is k * theta + rotation from
+ * the cos/sin planes, ROW takes cosf() and sinf() of a per sample angle and CONST uses the
+ * rotation alone. BAKED is a ROW angle whose per sample part AnimaxWarmup() baked into a
+ * phase plane, only the rotation is added.
+ */
+#define ANIMAX_MODE_PLANES  0
+#define ANIMAX_MODE_ROW     1
+#define ANIMAX_MODE_CONST   2
+#define ANIMAX_MODE_BAKED   3
+
+/* --------------------------------------------------------------------------------------------
+ * ANIMAX_FEED_* define
+ *
+ * Index of the AnimaxFeed of a layer for each per sample value it can feed
+ */
+#define ANIMAX_FEED_DIST    0
+#define ANIMAX_FEED_ANGLE   1
+#define ANIMAX_FEED_X       2
+#define ANIMAX_FEED_Y       3
+#define ANIMAX_NUM_FEEDS    4
+
+/* --------------------------------------------------------------------------------------------
+ * ANIMAX_POLAR_OVERSAMPLE define
+ *
+ * Samples of the polar wedge grid per cartesian block edge, along the radius and along the
+ * arc. The noise is resampled linearly, 4 keeps it within a few LSB of rendering every pixel.
+ */
+#ifndef ANIMAX_POLAR_OVERSAMPLE
+#define ANIMAX_POLAR_OVERSAMPLE 4
+#endif /* ANIMAX_POLAR_OVERSAMPLE */
+
+/* --------------------------------------------------------------------------------------------
+ * ANIMAX_POLAR_MAX_SAMPLES / ANIMAX_POLAR_MAX_RINGS define
+ *
+ * Size of the polar wedge grid a symmetric animation can render on instead of its cartesian
+ * grid, see AnimaxPolarLayout(). MAX_RINGS covers the corners of the matrix at full quality.
+ */
+#ifndef ANIMAX_POLAR_MAX_SAMPLES
+#define ANIMAX_POLAR_MAX_SAMPLES 1024
+#endif /* ANIMAX_POLAR_MAX_SAMPLES */
+
+#define ANIMAX_POLAR_MAX_RINGS \
+    (ANIMAX_POLAR_OVERSAMPLE * ((LEDI_WIDTH / 2) + (LEDI_HEIGHT / 2)) + 2)
+
+/* --------------------------------------------------------------------------------------------
+ * ANIMAX_DIAGNOSTICS define
+ *
+ * Set to 1 to have ANIMAX_Init() check the compile time polar tables against hypotf() and
+ * atan2f() and print the largest error, and to print every change of the adaptive quality
+ * level.
+ *
+ * Default is 0
+ */
+#ifndef ANIMAX_DIAGNOSTICS
+#define ANIMAX_DIAGNOSTICS 0
+#endif /* ANIMAX_DIAGNOSTICS */
+
+/* --------------------------------------------------------------------------------------------
+ * ANIMAX_ADAPT_* define
+ *
+ * Tuning of the adaptive quality controller, see AnimaxAdapt(). The render time is smoothed
+ * over about SMOOTHING frames once the first WARMUP frames at a level are over, a level is held
+ * for SETTLE frames before it can change again and a step is taken back once the frame is
+ * expected to fit HEADROOM percent of the budget without it.
+ */
+#define ANIMAX_ADAPT_SMOOTHING  8
+#define ANIMAX_ADAPT_WARMUP     2
+#define ANIMAX_ADAPT_SETTLE     16
+#define ANIMAX_ADAPT_HEADROOM   80
+
+/* Most steps the controller can take. Every resolution, the noise volume, and all but one layer */
+#define ANIMAX_ADAPT_MAX_LEVEL  ((ANIMAX_NUM_QUALITY - 1) + 1 + (ANIMAX_MAX_LAYERS - 1))
+
 /* --------------------------------------------------------------------------------------------
  *  GLOBALS
  * --------------------------------------------------------------------------------------------
  */
 
-static float *polar_theta;        // look-up table for polar angles
-static float *distance;           // look-up table for polar distances
+/* Sample grid of one AnimaxQuality. Every sample stands for a block of 2^shift x 2^shift
+ * pixels and the tables hold the polar coordinates of the center of its block, in full
+ * resolution pixel units, so an animation keeps its geometry at every quality.
+ * The grid is mirror symmetric about the center, so the tables only hold the lower right
+ * quadrant (width / 2 x height / 2 samples, x and y from the center up) as uint16, scaled by
+ * the ANIMAX_*_LSB defines. AnimaxDecodeRow() mirrors them back out.
+ */
+typedef struct _AnimaxGrid {
+
+    uint16_t width;                 // samples per row
+    uint16_t height;                // rows of samples
+    uint8_t shift;                  // log2 of the block edge, same as the AnimaxQuality
+    const uint16_t *polar_theta;    // look-up table for polar angles
+    const uint16_t *distance;       // look-up table for polar distances
+    const uint16_t *cos_theta;      // look-up table for cosf(polar_theta)
+    const uint16_t *sin_theta;      // look-up table for sinf(polar_theta)
+} AnimaxGrid;
+
+/* Samples in the quadrant the polar tables of AnimaxQuality Q hold */
+#define ANIMAX_QUADRANT_SIZE(Q) \
+    ((ANIMAX_GRID_DIM(LEDI_WIDTH, Q) / 2) * (ANIMAX_GRID_DIM(LEDI_HEIGHT, Q) / 2))
+
+/* The polar tables of the grid of AnimaxQuality Q */
+template <uint8_t Q>
+struct AnimaxPolarTables {
+
+    uint16_t polar_theta[ANIMAX_QUADRANT_SIZE(Q)];
+    uint16_t distance[ANIMAX_QUADRANT_SIZE(Q)];
+    uint16_t cos_theta[ANIMAX_QUADRANT_SIZE(Q)];
+    uint16_t sin_theta[ANIMAX_QUADRANT_SIZE(Q)];
+};
+
+// Square root by Newton's method, usable in constant expressions
+
+static constexpr double AnimaxCtSqrt(double V)
+{
+  double x = (V > 1) ? V : 1;
+
+  for (int i = 0; i < 40; i++) {
+    x = 0.5 * (x + V / x);
+  }
+  return x;
+}
+
+// Arc tangent for |X| <= 1, usable in constant expressions. Two half angle
+// steps bring X below tan(pi/16) where the series converges quickly
+
+static constexpr double AnimaxCtAtan(double X)
+{
+  double x = X / (1 + AnimaxCtSqrt(1 + X * X));
+  double sum = 0, term = 0;
+
+  x = x / (1 + AnimaxCtSqrt(1 + x * x));
+  sum = term = x;
+  for (int n = 1; n < 12; n++) {
+    term *= -x * x;
+    sum += term / (2 * n + 1);
+  }
+  return 4 * sum;
+}
+
+static constexpr double AnimaxCtAtan2(double Y, double X)
+{
+  double ax = (X < 0) ? -X : X;
+  double ay = (Y < 0) ? -Y : Y;
+
+  if (ax == 0 && ay == 0) {
+    return 0;
+  }
+  if (ax >= ay) {
+    double a = AnimaxCtAtan(Y / X);
+    return (X > 0) ? a : ((Y >= 0) ? a + PI : a - PI);
+  }
+  return ((Y > 0) ? PI / 2 : -PI / 2) - AnimaxCtAtan(X / Y);
+}
+
+// Rounds a non negative value to the nearest multiple of Lsb
+
+static constexpr uint16_t AnimaxCtFixed(double V, double Lsb)
+{
+  return (uint16_t)(V / Lsb + 0.5);
+}
+
+// given a static polar origin we can precalculate the polar
+// coordinates, here at compile time. Every sample of a reduced
+// grid takes the coordinates of the center of its block. Only
+// the quadrant right of and below the center is kept, dx and dy
+// are never 0 there as the center falls between samples
+
+template <uint8_t Q>
+static constexpr AnimaxPolarTables<Q> AnimaxMakePolarTables()
+{
+  AnimaxPolarTables<Q> t = {};
+  uint16_t width  = ANIMAX_GRID_DIM(LEDI_WIDTH, Q);
+  uint16_t height = ANIMAX_GRID_DIM(LEDI_HEIGHT, Q);
+  uint32_t pix = 0;
+
+  for (uint16_t yy = height / 2; yy < height; yy++) {
+    for (uint16_t xx = width / 2; xx < width; xx++, pix++) {
+      double dx = (xx << Q) + ((1 << Q) - 1) * 0.5 - ANIMAX_CENTER_X;
+      double dy = (yy << Q) + ((1 << Q) - 1) * 0.5 - ANIMAX_CENTER_Y;
+      double d  = AnimaxCtSqrt(dx * dx + dy * dy);
+
+      t.distance[pix]    = AnimaxCtFixed(d, ANIMAX_DIST_LSB);
+      t.polar_theta[pix] = AnimaxCtFixed(AnimaxCtAtan2(dy, dx), ANIMAX_ANGLE_LSB);
+      t.cos_theta[pix]   = AnimaxCtFixed(dx / d, ANIMAX_UNIT_LSB);
+      t.sin_theta[pix]   = AnimaxCtFixed(dy / d, ANIMAX_UNIT_LSB);
+    }
+  }
+  return t;
+}
+
+static_assert(ANIMAX_GRID_DIM(LEDI_WIDTH, ANIMAX_QUALITY_QUARTER) % 2 == 0 &&
+              ANIMAX_GRID_DIM(LEDI_HEIGHT, ANIMAX_QUALITY_QUARTER) % 2 == 0,
+              "quadrant polar tables need an even number of samples per edge");
+static_assert(AnimaxCtSqrt(ANIMAX_CENTER_X * ANIMAX_CENTER_X + ANIMAX_CENTER_Y * ANIMAX_CENTER_Y) <
+              65535 * ANIMAX_DIST_LSB, "ANIMAX_DIST_FRAC_BITS too large for the matrix");
+
+/* Built by the compiler and kept in flash (PROGMEM) instead of 4 RAM tables per grid */
+static constexpr AnimaxPolarTables<ANIMAX_QUALITY_FULL> polarFull PROGMEM =
+    AnimaxMakePolarTables<ANIMAX_QUALITY_FULL>();
+static constexpr AnimaxPolarTables<ANIMAX_QUALITY_HALF> polarHalf PROGMEM =
+    AnimaxMakePolarTables<ANIMAX_QUALITY_HALF>();
+static constexpr AnimaxPolarTables<ANIMAX_QUALITY_QUARTER> polarQuarter PROGMEM =
+    AnimaxMakePolarTables<ANIMAX_QUALITY_QUARTER>();
+
+#define ANIMAX_GRID(Q, T) {ANIMAX_GRID_DIM(LEDI_WIDTH, Q), ANIMAX_GRID_DIM(LEDI_HEIGHT, Q), Q, \
+                           T.polar_theta, T.distance, T.cos_theta, T.sin_theta}
+
+/* One per AnimaxQuality */
+static const AnimaxGrid grids[ANIMAX_NUM_QUALITY] = {
+    ANIMAX_GRID(ANIMAX_QUALITY_FULL, polarFull),
+    ANIMAX_GRID(ANIMAX_QUALITY_HALF, polarHalf),
+    ANIMAX_GRID(ANIMAX_QUALITY_QUARTER, polarQuarter),
+};
+
+/* Arena AnimaxWarmup() bakes the planes of the animations into. A warm-up that doesn't fit
+ * behind the ones before it starts over at the beginning and moves the epoch on, which leaves
+ * the planes baked in the earlier epoch stale.
+ */
+static struct {
+    uint8_t *base;                  // ANIMAX_ARENA_SIZE bytes, 0 when there is no arena
+    uint32_t used;
+    uint32_t epoch;
+} animaxArena;
+
+/* --------------------------------------------------------------------------------------------
+ * AnimaxMod type
+ *
+ * A modulator an AnimaxBind reads. The upper nibble picks the Modulators array, the lower
+ * nibble the oscillator.
+ */
+typedef uint8_t AnimaxMod;
 
-static unsigned long a, b, c;                  // for time measurements
+/* The constant 1 */
+#define ANIMAX_ONE                         0x00
 
-typedef struct _RenderParameters {
+/* move.linear[N], move.radial[N], move.directional[N] and move.noise_angle[N] */
+#define ANIMAX_LIN(N)                      (0x10 | (N))
+#define ANIMAX_RAD(N)                      (0x20 | (N))
+#define ANIMAX_DIR(N)                      (0x30 | (N))
+#define ANIMAX_NOISE(N)                    (0x40 | (N))
 
-    float center_x;                 // center of the matrix
-    float center_y;
-    float dist, angle;                
-    float scale_x;                  // smaller values = zoom in
-    float scale_y;
-    float scale_z;       
-    float offset_x, offset_y, offset_z;     
-    float z;  
-    float low_limit;                 // getting contrast by highering the black point
-    float high_limit;                                            
-} RenderParameters;
+/* End AnimaxMod type */
 
-static RenderParameters animation;     // all animation parameters in one place
+/* --------------------------------------------------------------------------------------------
+ * AnimaxDist type
+ *
+ * Shape of the distance a layer is rendered at, as a function of the distance d of the sample
+ * from the center.
+ */
+typedef uint8_t AnimaxDist;
+
+/* d */
+#define ANIMAX_DIST_LINEAR                 0
+
+/* d * d */
+#define ANIMAX_DIST_SQUARE                 1
+
+/* sqrt(d) */
+#define ANIMAX_DIST_SQRT                   2
+
+/* End AnimaxDist type */
+
+/* --------------------------------------------------------------------------------------------
+ * AnimaxNoise type
+ *
+ * Noise a layer samples. Plain Perlin noise from the noise engine of the animation, or
+ * ANOISE_FbmBatch() with N octaves, 2 to ANOISE_FBM_MAX_OCTAVES. fBm layers always use the
+ * float engine.
+ */
+typedef uint8_t AnimaxNoise;
+
+/* One octave of ANOISE_SRC_* noise */
+#define ANIMAX_PERLIN                      0
+
+/* N octaves of fBm, -1 to 1. Clouds */
+#define ANIMAX_FBM(N)                      (N)
+
+/* N octaves of turbulence, the sum of |noise|, 0 to 1. Fire and marble */
+#define ANIMAX_TURB(N)                     (0x80 | (N))
+
+#define ANIMAX_NOISE_OCTAVES(NOISE)        ((NOISE) & 0x7F)
+#define ANIMAX_NOISE_TURB(NOISE)           (((NOISE) & 0x80) != 0)
+
+/* End AnimaxNoise type */
 
 typedef struct _Oscillators {
 
     float master_speed;            // global transition speed
     float offset[NUM_OSCILLATORS]; // oscillators can be shifted by a time offset
-    float ratio[NUM_OSCILLATORS];  // speed ratios for the individual oscillators                                  
+    float ratio[NUM_OSCILLATORS];  // speed ratios for the individual oscillators
 } Oscillators;
 
-static Oscillators timings;             // all speed settings in one place
-
-typedef struct _Modulators {  
+typedef struct _Modulators {
 
     float linear[NUM_OSCILLATORS];        // returns 0 to FLT_MAX
     float radial[NUM_OSCILLATORS];        // returns 0 to 2*PI
     float directional[NUM_OSCILLATORS];   // returns -1 to 1
-    float noise_angle[NUM_OSCILLATORS];   // returns 0 to 2*PI        
+    float noise_angle[NUM_OSCILLATORS];   // returns 0 to 2*PI
 } Modulators;
 
-Modulators move;                 // all oscillator based movers and shifters at one place
-
-typedef struct _AnimaxRgb {
-
-  float red, green, blue;
-} AnimaxRgb;
-AnimaxRgb pixel;
-
-static const byte p[] = {   151,160,137,91,90, 15,131, 13,201,95,96,
-53,194,233, 7,225,140,36,103,30,69,142, 8,99,37,240,21,10,23,190, 6,
-148,247,120,234,75, 0,26,197,62,94,252,219,203,117, 35,11,32,57,177,
-33,88,237,149,56,87,174,20,125,136,171,168,68,175,74,165,71,134,139,
-48,27,166, 77,146,158,231,83,111,229,122, 60,211,133,230,220,105,92,
-41,55,46,245,40,244,102,143,54,65,25,63,161, 1,216,80,73,209,76,132,
-187,208, 89, 18,169,200,196,135,130,116,188,159, 86,164,100,109,198,
-173,186, 3,64,52,217,226,250,124,123,5,202,38,147,118,126,255,82,85,
-212,207,206, 59,227, 47,16,58,17,182,189, 28,42,223,183,170,213,119,
-248,152,2,44,154,163,70,221,153,101,155,167,43,172, 9,129,22,39,253,
-19,98,108,110,79,113,224,232,178,185,112,104,218,246, 97,228,251,34,
-242,193,238,210,144,12,191,179,162,241,81,51,145,235,249,14,239,107,
-49,192,214, 31,181,199,106,157,184, 84,204,176,115,121,50,45,127, 4,
-150,254,138,236,205, 93,222,114, 67,29,24, 72,243,141,128,195,78,66,
-215,61,156,180
+
+/* A frame invariant parameter of a layer, base + k * a * b where a and b are modulators.
+ * Evaluated once per frame by AnimaxBindLayers(). Use the ANIMAX_K/M/KM/MM macros.
+ */
+typedef struct _AnimaxBind {
+
+    float base;
+    float k;
+    AnimaxMod a, b;
+} AnimaxBind;
+
+/* Adds k times the output of an earlier layer to a per sample value. Layer -1 for none */
+typedef struct _AnimaxFeed {
+
+    int8_t layer;
+    float k;
+} AnimaxFeed;
+
+/* One noise layer of an animation. The sample at distance d and angle theta of the grid is
+ * rendered at
+ *
+ *   dist  = dist * shape(d) + feed[DIST]
+ *   angle = angleMult * theta + angle + spin + twist * d + feed[ANGLE]
+ *   x     = (offsetX + feed[X] + center_x - cos(angle) * dist) * scaleX
+ *   y     = (offsetY + feed[Y] + center_y - sin(angle) * dist) * scaleY
+ *   z     = (offsetZ + z + zDist * d) * scaleZ
+ *
+ * and the noise there is mapped from lowLimit..1 to 0..255.
+ */
+typedef struct _AnimaxLayer {
+
+    uint8_t angleMult;              // 0 to 5. 0 leaves only the angle terms that are set
+    AnimaxDist distShape;           // shape(d)
+    AnimaxBind dist;                // distance scale
+    AnimaxBind angle;               // rotation
+    AnimaxBind spin;                // second rotation term, added to angle
+    AnimaxBind twist;               // angle per unit of distance, for spirals
+    AnimaxBind scaleX, scaleY, scaleZ;   // smaller values = zoom in
+    AnimaxBind offsetX, offsetY, offsetZ;
+    AnimaxBind z;
+    float zDist;                    // z per unit of distance
+    float lowLimit;                 // getting contrast by highering the black point
+    AnimaxNoise noise;              // Perlin, fBm or turbulence
+    AnimaxFeed feed[ANIMAX_NUM_FEEDS];
+} AnimaxLayer;
+
+/* One color channel of the colormap. The sum of k[i] times layer i and prodK times layer
+ * prodA times layer prodB, multiplied by the ANIMAX_MASK_* masks that are set.
+ */
+typedef struct _AnimaxChannel {
+
+    float k[ANIMAX_MAX_LAYERS];
+    float prodK;
+    uint8_t prodA, prodB;
+    uint8_t masks;
+} AnimaxChannel;
+
+typedef struct _AnimaxColormap {
+
+    AnimaxChannel red, green, blue;
+    float radius;                   // radius of the FADE and BLOB masks
+    float rowBias, rowDiv;          // the ROW mask is (y + rowBias) / rowDiv
+    float cutoff;                   // samples further from the center are black. 0 for none
+} AnimaxColormap;
+
+/* Everything an ANIMAX animation is made of. Rendered by AnimaxRender() */
+typedef struct _AnimaxDesc {
+
+    Oscillators timings;
+    uint8_t numLayers;
+    AnimaxLayer layers[ANIMAX_MAX_LAYERS];
+    AnimaxColormap colormap;
+} AnimaxDesc;
+
+/* An AnimaxLayer with its binds evaluated and folded together for the current frame */
+typedef struct _AnimaxFrameLayer {
+
+    uint8_t mode;                   // AnimaxRenderLayer() specialization, ANIMAX_MODE_*
+    uint8_t angleMult;
+    AnimaxDist distShape;
+    float dist;
+    float angle;                    // angle + spin
+    float twist;
+    float rotCos, rotSin;           // cos and sin of angle
+    float scaleX, scaleY;
+    float baseX, baseY;             // offset + center
+    float baseZ, zStep;             // z is baseZ + zStep * d, scaleZ already applied
+    float lowLimit;
+    float lowScale;                 // 255 / (1 - lowLimit), maps lowLimit..1 to 0..255
+    AnimaxNoise noise;
+    AnimaxFeed feed[ANIMAX_NUM_FEEDS];
+    uint8_t index;                  // of the layer in the AnimaxDesc, picks its planes
+} AnimaxFrameLayer;
+
+/* Polar wedge grid. The angles of the layers of a K-fold symmetric animation are all multiples
+ * of K * theta, so every layer repeats each 2 * PI / K around the center and only needs to be
+ * rendered on one wedge. Samples sit on rings step apart, a ring of radius r holds
+ * ceil(r / step * wedge) samples evenly spread over the wedge, step apart along the arc.
+ * An animation with no angle term at all is radially symmetric, its rings hold one sample.
+ */
+typedef struct _AnimaxPolar {
+
+    float wedge;                    // angle of the wedge, 0 for radially symmetric
+    float step;                     // spacing of the rings, block edge / ANIMAX_POLAR_OVERSAMPLE
+    uint16_t numRings;
+    uint16_t ringStart[ANIMAX_POLAR_MAX_RINGS + 1];  // first sample of every ring
+    float show[ANIMAX_MAX_LAYERS][ANIMAX_POLAR_MAX_SAMPLES];  // layer values of all samples
+} AnimaxPolar;
+
+/* Per sample values of an animation that don't change between frames, baked into the arena
+ * by AnimaxWarmup() for one grid. One entry per grid sample, 0 for the ones that aren't baked.
+ */
+typedef struct _AnimaxPlanes {
+
+    const AnimaxDesc *desc;         // animation the planes are of, 0 until the first warm-up
+    const AnimaxGrid *grid;         // grid they are baked for
+    uint32_t epoch;                 // arena epoch they were baked in
+    const int16_t *phase[ANIMAX_MAX_LAYERS];  // cos and sin of k * theta + twist * d, Q15 pairs
+    const float *shape[ANIMAX_MAX_LAYERS];    // distance shape of d of the layers
+    const float *mask[3];           // product of the masks of the red, green and blue channel
+} AnimaxPlanes;
+
+/* Render context of one ANIMAX animation. Every AniPack playing an ANIMAX animation owns one
+ * (AniParms p.animax.ctx) so any number of them can render at the same time.
+ */
+struct _AnimaxCtx {
+
+    AnimaxFrameLayer layers[ANIMAX_MAX_LAYERS];  // layers bound for the current frame
+    AnoiseSrc noiseSrc;             // noise engine, taken from the AniParms of the animation
+    Oscillators timings;            // all speed settings in one place
+    Modulators move;                // all oscillator based movers and shifters at one place
+    const AnimaxGrid *grid;         // grid the current frame renders on
+    CRGB *lowRes;                   // colors of a reduced quality frame, allocated on first use
+                                    // and freed when it goes inactive
+    uint8_t *visible;               // samples of a reduced quality frame the upscale shows
+    float support;                  // samples further from the center are black. 0 for none
+    AnimaxPolar *polar;             // polar wedge grid, allocated on first use and freed
+                                    // when it goes inactive
+    uint8_t numLayers;              // layers rendered this frame, the rest are held
+    uint16_t *held;                 // layers past the first at the values they were last shown
+                                    // with on the quarter grid, 8.8 fixed point, allocated on
+                                    // first use and freed when it goes inactive
+    uint8_t level;                  // adaptive quality level, 0 renders as configured
+    uint8_t settle;                 // frames rendered at the level, up to ANIMAX_ADAPT_SETTLE
+    float renderUs;                 // smoothed render time at the level
+    float upperUs;                  // smoothed render time at the level above, until settled
+    float saved[ANIMAX_ADAPT_MAX_LEVEL + 1];  // time at the level above / time at each level
+    uint16_t *keys;                 // two keyframes of the layers of every sample, 8.8 fixed point,
+                                    // allocated on first use and freed when it goes inactive
+    uint32_t keySize;               // samples times layers one keyframe has room for
+    const AnimaxDesc *keyDesc;      // animation the keyframes are of, 0 when there are none
+    const AnimaxGrid *keyGrid;      // grid the keyframes are on
+    uint8_t keyLayers;              // layers the keyframes hold
+    uint8_t keyNew;                 // which of the two keyframes is the newer one
+    bool keyDue;                    // the layers are rendered into the newer keyframe this frame
+    uint32_t keyMs[2];              // time of the older and of the newer keyframe
+    AnimaxPlanes planes;            // per sample values baked by AnimaxWarmup()
+};
+
+/* Polar coordinates of the samples of one span, decoded from the grid tables */
+typedef struct _AnimaxRow {
+
+    float dist[LEDI_WIDTH];
+    float theta[LEDI_WIDTH];
+    float cosTheta[LEDI_WIDTH];
+    float sinTheta[LEDI_WIDTH];
+    const int16_t *phase[ANIMAX_MAX_LAYERS];  // AnimaxPlanes of the span, 0 for none
+    const float *shape[ANIMAX_MAX_LAYERS];
+    const float *mask[3];
+} AnimaxRow;
+
+/* --------------------------------------------------------------------------------------------
+ *  ANIMATIONS
+ * --------------------------------------------------------------------------------------------
+ * Each animation is one AnimaxDesc. Layer lines are
+ *
+ *   angle mult, dist shape, dist scale
+ *   angle, spin, twist
+ *   scale x, y, z
+ *   offset x, y, z
+ *   z, z per dist, low limit, noise
+ *   feeds into dist, angle, x, y
+ *
+ * and the colormap is red, green, blue, then radius, row bias, row divider and cutoff.
+ */
+
+static const AnimaxDesc animaxLava1 = {
+  {0.0015, ANIMAX_DEFAULT_OFFSETS, {4, 1, 1, 0.05, 0.6, 6, 7, 8, 9, 10}},
+  3,
+  {
+    { 1, ANIMAX_DIST_LINEAR, ANIMAX_K(0.8),
+      ANIMAX_K(0), ANIMAX_K(0), ANIMAX_K(0),
+      ANIMAX_K(0.15), ANIMAX_K(0.12), ANIMAX_K(0.01),
+      ANIMAX_K(0), ANIMAX_M(-1, ANIMAX_LIN(0)), ANIMAX_K(0),
+      ANIMAX_K(30), 0, 0, ANIMAX_PERLIN,
+      ANIMAX_NO_FEEDS },
+    { 1, ANIMAX_DIST_LINEAR, ANIMAX_K(0.8),
+      ANIMAX_K(0), ANIMAX_K(0), ANIMAX_K(0),
+      ANIMAX_K(0.15), ANIMAX_K(0.12), ANIMAX_K(0.01),
+      ANIMAX_K(0), ANIMAX_M(-1, ANIMAX_LIN(1)), ANIMAX_K(0),
+      ANIMAX_K(30), 0, 0, ANIMAX_PERLIN,
+      {ANIMAX_NO_FEED, ANIMAX_NO_FEED, ANIMAX_FEED(0, 0.01), ANIMAX_FEED(0, 0.01)} },
+    { 1, ANIMAX_DIST_LINEAR, ANIMAX_K(0.8),
+      ANIMAX_K(0), ANIMAX_K(0), ANIMAX_K(0),
+      ANIMAX_K(0.15), ANIMAX_K(0.12), ANIMAX_K(0.01),
+      ANIMAX_K(0), ANIMAX_M(-1, ANIMAX_LIN(2)), ANIMAX_K(0),
+      ANIMAX_K(30), 0, 0, ANIMAX_PERLIN,
+      {ANIMAX_NO_FEED, ANIMAX_NO_FEED, ANIMAX_FEED(1, 0.01), ANIMAX_FEED(1, 0.01)} },
+  },
+  { ANIMAX_CH(0, 1, 0, 0, ANIMAX_MASK_ROW),          // linear vertical mask
+    ANIMAX_CH(0, 0.1, -0.1, 0, ANIMAX_MASK_ROW),
+    ANIMAX_CH(0, 0, 0, 0, 0),
+    0, 0, LEDI_HEIGHT - 1, 0 },
+};
+
+static const AnimaxDesc animaxChasingSpirals = {
+  {0.01, {0, 10, 20, 30, 400, 500, 600, 700, 800, 900}, {0.1, 0.13, 0.16, 4, 5, 6, 7, 8, 9, 10}},
+  3,
+  {
+    { 3, ANIMAX_DIST_LINEAR, ANIMAX_K(1),
+      ANIMAX_M(1, ANIMAX_RAD(0)), ANIMAX_K(0), ANIMAX_K(-1.f / 3),
+      ANIMAX_K(0.1), ANIMAX_K(0.1), ANIMAX_K(0.1),
+      ANIMAX_M(1, ANIMAX_LIN(0)), ANIMAX_K(0), ANIMAX_K(0),
+      ANIMAX_K(0), 0, 0, ANIMAX_PERLIN,
+      ANIMAX_NO_FEEDS },
+    { 3, ANIMAX_DIST_LINEAR, ANIMAX_K(1),
+      ANIMAX_M(1, ANIMAX_RAD(1)), ANIMAX_K(0), ANIMAX_K(-1.f / 3),
+      ANIMAX_K(0.1), ANIMAX_K(0.1), ANIMAX_K(0.1),
+      ANIMAX_M(1, ANIMAX_LIN(1)), ANIMAX_K(0), ANIMAX_K(0),
+      ANIMAX_K(0), 0, 0, ANIMAX_PERLIN,
+      ANIMAX_NO_FEEDS },
+    { 3, ANIMAX_DIST_LINEAR, ANIMAX_K(1),
+      ANIMAX_M(1, ANIMAX_RAD(2)), ANIMAX_K(0), ANIMAX_K(-1.f / 3),
+      ANIMAX_K(0.1), ANIMAX_K(0.1), ANIMAX_K(0.1),
+      ANIMAX_M(1, ANIMAX_LIN(2)), ANIMAX_K(0), ANIMAX_K(0),
+      ANIMAX_K(0), 0, 0, ANIMAX_PERLIN,
+      ANIMAX_NO_FEEDS },
+  },
+  { ANIMAX_CH(3, 0, 0, 0, ANIMAX_MASK_FADE),
+    ANIMAX_CH(0, 0.5, 0, 0, ANIMAX_MASK_FADE),
+    ANIMAX_CH(0, 0, 0.25, 0, ANIMAX_MASK_FADE),
+    10, 0, 0, 0 },
+};
+
+static const AnimaxDesc animaxCaleido1 = {
+  {0.003, ANIMAX_DEFAULT_OFFSETS, {0.02, 0.03, 0.04, 0.05, 0.6, 6, 7, 8, 9, 10}},
+  4,
+  {
+    { 3, ANIMAX_DIST_LINEAR, ANIMAX_KM(2.f / 3, 1.f / 3, ANIMAX_DIR(0)),
+      ANIMAX_M(3, ANIMAX_NOISE(0)), ANIMAX_M(1, ANIMAX_RAD(4)), ANIMAX_K(0),
+      ANIMAX_K(0.1), ANIMAX_K(0.1), ANIMAX_K(0.1),
+      ANIMAX_K(0), ANIMAX_M(2, ANIMAX_LIN(0)), ANIMAX_K(0),
+      ANIMAX_M(1, ANIMAX_LIN(0)), 0, 0, ANIMAX_PERLIN,
+      ANIMAX_NO_FEEDS },
+    { 4, ANIMAX_DIST_LINEAR, ANIMAX_KM(2.f / 3, 1.f / 3, ANIMAX_DIR(1)),
+      ANIMAX_M(3, ANIMAX_NOISE(1)), ANIMAX_M(1, ANIMAX_RAD(4)), ANIMAX_K(0),
+      ANIMAX_K(0.1), ANIMAX_K(0.1), ANIMAX_K(0.1),
+      ANIMAX_M(2, ANIMAX_LIN(1)), ANIMAX_M(2, ANIMAX_LIN(0)), ANIMAX_K(0),
+      ANIMAX_M(1, ANIMAX_LIN(1)), 0, 0, ANIMAX_PERLIN,
+      ANIMAX_NO_FEEDS },
+    { 5, ANIMAX_DIST_LINEAR, ANIMAX_KM(2.f / 3, 1.f / 3, ANIMAX_DIR(2)),
+      ANIMAX_M(3, ANIMAX_NOISE(2)), ANIMAX_M(1, ANIMAX_RAD(4)), ANIMAX_K(0),
+      ANIMAX_K(0.1), ANIMAX_K(0.1), ANIMAX_K(0.1),
+      ANIMAX_M(2, ANIMAX_LIN(1)), ANIMAX_M(2, ANIMAX_LIN(2)), ANIMAX_K(0),
+      ANIMAX_M(1, ANIMAX_LIN(2)), 0, 0, ANIMAX_PERLIN,
+      ANIMAX_NO_FEEDS },
+    { 4, ANIMAX_DIST_LINEAR, ANIMAX_KM(2.f / 3, 1.f / 3, ANIMAX_DIR(3)),
+      ANIMAX_M(3, ANIMAX_NOISE(3)), ANIMAX_M(1, ANIMAX_RAD(4)), ANIMAX_K(0),
+      ANIMAX_K(0.1), ANIMAX_K(0.1), ANIMAX_K(0.1),
+      ANIMAX_M(2, ANIMAX_LIN(3)), ANIMAX_M(2, ANIMAX_LIN(2)), ANIMAX_K(0),
+      ANIMAX_M(1, ANIMAX_LIN(3)), 0, 0, ANIMAX_PERLIN,
+      ANIMAX_NO_FEEDS },
+  },
+  { ANIMAX_CH(1, 0, 0, 0, 0),
+    ANIMAX_CH(0, 0, 0.1, 0, ANIMAX_MASK_DIST),
+    ANIMAX_CH(0, 0.5, 0, 0.5, 0),
+    0, 0, 0, 0 },
+};
+
+static const AnimaxDesc animaxCaleido2 = {
+  {0.002, ANIMAX_DEFAULT_OFFSETS, {0.02, 0.03, 0.04, 0.05, 0.6, 6, 7, 8, 9, 10}},
+  4,
+  {
+    { 2, ANIMAX_DIST_LINEAR, ANIMAX_KM(2.f / 3, 1.f / 3, ANIMAX_DIR(0)),
+      ANIMAX_M(3, ANIMAX_NOISE(0)), ANIMAX_M(1, ANIMAX_RAD(4)), ANIMAX_K(0),
+      ANIMAX_K(0.1), ANIMAX_K(0.1), ANIMAX_K(0.1),
+      ANIMAX_K(0), ANIMAX_M(2, ANIMAX_LIN(0)), ANIMAX_K(0),
+      ANIMAX_M(1, ANIMAX_LIN(0)), 0, 0, ANIMAX_PERLIN,
+      ANIMAX_NO_FEEDS },
+    { 2, ANIMAX_DIST_LINEAR, ANIMAX_KM(2.f / 3, 1.f / 3, ANIMAX_DIR(1)),
+      ANIMAX_M(3, ANIMAX_NOISE(1)), ANIMAX_M(1, ANIMAX_RAD(4)), ANIMAX_K(0),
+      ANIMAX_K(0.1), ANIMAX_K(0.1), ANIMAX_K(0.1),
+      ANIMAX_M(2, ANIMAX_LIN(1)), ANIMAX_M(2, ANIMAX_LIN(0)), ANIMAX_K(0),
+      ANIMAX_M(1, ANIMAX_LIN(1)), 0, 0, ANIMAX_PERLIN,
+      ANIMAX_NO_FEEDS },
+    { 2, ANIMAX_DIST_LINEAR, ANIMAX_KM(2.f / 3, 1.f / 3, ANIMAX_DIR(2)),
+      ANIMAX_M(3, ANIMAX_NOISE(2)), ANIMAX_M(1, ANIMAX_RAD(4)), ANIMAX_K(0),
+      ANIMAX_K(0.1), ANIMAX_K(0.1), ANIMAX_K(0.1),
+      ANIMAX_M(2, ANIMAX_LIN(1)), ANIMAX_M(2, ANIMAX_LIN(2)), ANIMAX_K(0),
+      ANIMAX_M(1, ANIMAX_LIN(2)), 0, 0, ANIMAX_PERLIN,
+      ANIMAX_NO_FEEDS },
+    { 2, ANIMAX_DIST_LINEAR, ANIMAX_KM(2.f / 3, 1.f / 3, ANIMAX_DIR(3)),
+      ANIMAX_M(3, ANIMAX_NOISE(3)), ANIMAX_M(1, ANIMAX_RAD(4)), ANIMAX_K(0),
+      ANIMAX_K(0.1), ANIMAX_K(0.1), ANIMAX_K(0.1),
+      ANIMAX_M(2, ANIMAX_LIN(3)), ANIMAX_M(2, ANIMAX_LIN(2)), ANIMAX_K(0),
+      ANIMAX_M(1, ANIMAX_LIN(3)), 0, 0, ANIMAX_PERLIN,
+      ANIMAX_NO_FEEDS },
+  },
+  { ANIMAX_CH(1, 0, 0, 0, 0),
+    ANIMAX_CH(0, 0, 0.1, 0, ANIMAX_MASK_DIST),
+    ANIMAX_CH(0, 0.5, 0, 0.5, 0),
+    0, 0, 0, 0 },
+};
+
+static const AnimaxDesc animaxCaleido3 = {
+  {0.004, ANIMAX_DEFAULT_OFFSETS, {0.02, 0.03, 0.04, 0.05, 0.6, 6, 7, 8, 9, 10}},
+  4,
+  {
+    { 2, ANIMAX_DIST_LINEAR, ANIMAX_KM(2.f / 3, 1.f / 3, ANIMAX_DIR(0)),
+      ANIMAX_M(3, ANIMAX_NOISE(0)), ANIMAX_M(1, ANIMAX_RAD(4)), ANIMAX_K(0),
+      ANIMAX_K(0.1), ANIMAX_K(0.1), ANIMAX_K(0.1),
+      ANIMAX_M(2, ANIMAX_LIN(1)), ANIMAX_M(2, ANIMAX_LIN(0)), ANIMAX_K(0),
+      ANIMAX_M(1, ANIMAX_LIN(0)), 0, 0, ANIMAX_PERLIN,
+      ANIMAX_NO_FEEDS },
+    { 2, ANIMAX_DIST_LINEAR, ANIMAX_KM(2.f / 3, 1.f / 3, ANIMAX_DIR(1)),
+      ANIMAX_M(3, ANIMAX_NOISE(1)), ANIMAX_M(1, ANIMAX_RAD(4)), ANIMAX_K(0),
+      ANIMAX_K(0.1), ANIMAX_K(0.1), ANIMAX_K(0.1),
+      ANIMAX_M(2, ANIMAX_LIN(1)), ANIMAX_K(0), ANIMAX_K(0),
+      ANIMAX_M(1, ANIMAX_LIN(1)), 0, 0, ANIMAX_PERLIN,
+      {ANIMAX_NO_FEED, ANIMAX_NO_FEED, ANIMAX_NO_FEED, ANIMAX_FEED(0, 1.f / 20)} },
+    { 2, ANIMAX_DIST_LINEAR, ANIMAX_KM(2.f / 3, 1.f / 3, ANIMAX_DIR(2)),
+      ANIMAX_M(3, ANIMAX_NOISE(2)), ANIMAX_M(1, ANIMAX_RAD(4)), ANIMAX_K(0),
+      ANIMAX_K(0.1), ANIMAX_K(0.1), ANIMAX_K(0.1),
+      ANIMAX_K(0), ANIMAX_M(2, ANIMAX_LIN(2)), ANIMAX_K(0),
+      ANIMAX_M(1, ANIMAX_LIN(2)), 0, 0, ANIMAX_PERLIN,
+      {ANIMAX_NO_FEED, ANIMAX_NO_FEED, ANIMAX_FEED(1, 1.f / 20), ANIMAX_NO_FEED} },
+    { 2, ANIMAX_DIST_LINEAR, ANIMAX_KM(2.f / 3, 1.f / 3, ANIMAX_DIR(3)),
+      ANIMAX_M(3, ANIMAX_NOISE(3)), ANIMAX_M(1, ANIMAX_RAD(4)), ANIMAX_K(0),
+      ANIMAX_K(0.1), ANIMAX_K(0.1), ANIMAX_K(0.1),
+      ANIMAX_M(2, ANIMAX_LIN(3)), ANIMAX_K(0), ANIMAX_K(0),
+      ANIMAX_M(1, ANIMAX_LIN(3)), 0, 0, ANIMAX_PERLIN,
+      {ANIMAX_NO_FEED, ANIMAX_NO_FEED, ANIMAX_NO_FEED, ANIMAX_FEED(2, 1.f / 20)} },
+  },
+  { ANIMAX_CH(1, 0, 0, 0, ANIMAX_MASK_ROW),
+    ANIMAX_CH(0, 0, 0.1, 0, ANIMAX_MASK_DIST),
+    ANIMAX_CH(0, 0.5, 0, 0.5, 0),
+    0, 1, LEDI_HEIGHT, 8 },                          // radial mask
+};
+
+static const AnimaxDesc animaxScaledemo1 = {
+  {0.00003, ANIMAX_DEFAULT_OFFSETS, {4, 3.2, 10, 0.05, 0.6, 6, 7, 8, 9, 10}},
+  2,
+  {
+    { 3, ANIMAX_DIST_LINEAR, ANIMAX_K(0.3 * 0.8),
+      ANIMAX_M(1, ANIMAX_RAD(2)), ANIMAX_K(0), ANIMAX_K(0),
+      ANIMAX_KM(0.1, 0.1, ANIMAX_NOISE(0)), ANIMAX_KM(0.1, 0.1, ANIMAX_NOISE(1)), ANIMAX_K(0.01),
+      ANIMAX_K(0), ANIMAX_K(0), ANIMAX_M(100, ANIMAX_LIN(0)),
+      ANIMAX_K(30), 0, 0, ANIMAX_PERLIN,
+      ANIMAX_NO_FEEDS },
+    { 0, ANIMAX_DIST_LINEAR, ANIMAX_K(0.3 * 0.8),
+      ANIMAX_K(3), ANIMAX_K(0), ANIMAX_K(0),
+      ANIMAX_KM(0.1, 0.1, ANIMAX_NOISE(0)), ANIMAX_KM(0.1, 0.1, ANIMAX_NOISE(1)), ANIMAX_K(0.01),
+      ANIMAX_K(0), ANIMAX_K(0), ANIMAX_M(100, ANIMAX_LIN(0)),
+      ANIMAX_K(30), 0, 0, ANIMAX_PERLIN,
+      ANIMAX_NO_FEEDS },
+  },
+  { ANIMAX_CH(1, 0, 0, 0, ANIMAX_MASK_FADE),
+    ANIMAX_CH(0.3, -0.3, 0, 0, ANIMAX_MASK_FADE),
+    ANIMAX_CH(-1, 1, 0, 0, ANIMAX_MASK_FADE),
+    10, 0, 0, 8 },
+};
+
+static const AnimaxDesc animaxYves = {
+  {0.001, ANIMAX_DEFAULT_OFFSETS, {3, 2, 1, 0.13, 0.15, 0.03, 0.025, 8, 9, 10}},
+  4,
+  {
+    { 1, ANIMAX_DIST_LINEAR, ANIMAX_K(1),
+      ANIMAX_KM(2 * PI, 1, ANIMAX_NOISE(5)), ANIMAX_K(0), ANIMAX_K(0),
+      ANIMAX_K(0.08), ANIMAX_K(0.08), ANIMAX_K(0.08),
+      ANIMAX_K(0), ANIMAX_M(-1, ANIMAX_LIN(0)), ANIMAX_K(0),
+      ANIMAX_K(0), 0, 0, ANIMAX_PERLIN,
+      ANIMAX_NO_FEEDS },
+    { 1, ANIMAX_DIST_LINEAR, ANIMAX_K(1),
+      ANIMAX_KM(2 * PI, 1, ANIMAX_NOISE(6)), ANIMAX_K(0), ANIMAX_K(0),
+      ANIMAX_K(0.08), ANIMAX_K(0.08), ANIMAX_K(0.08),
+      ANIMAX_K(0), ANIMAX_M(-1, ANIMAX_LIN(1)), ANIMAX_K(0),
+      ANIMAX_K(0), 0, 0, ANIMAX_PERLIN,
+      ANIMAX_NO_FEEDS },
+    { 1, ANIMAX_DIST_LINEAR, ANIMAX_K(1),
+      ANIMAX_M(1, ANIMAX_NOISE(3)), ANIMAX_M(1, ANIMAX_NOISE(4)), ANIMAX_K(0),
+      ANIMAX_K(0.08), ANIMAX_K(0.08), ANIMAX_K(0.08),
+      ANIMAX_K(0), ANIMAX_M(-1, ANIMAX_LIN(2)), ANIMAX_K(0),
+      ANIMAX_K(0), 0, 0, ANIMAX_PERLIN,
+      {ANIMAX_FEED(1, 1.f / 50), ANIMAX_FEED(0, 1.f / 100), ANIMAX_FEED(1, 1.f / 100),
+       ANIMAX_FEED(0, 1.f / 100)} },
+    { 1, ANIMAX_DIST_LINEAR, ANIMAX_K(1),
+      ANIMAX_M(1, ANIMAX_NOISE(3)), ANIMAX_M(1, ANIMAX_NOISE(4)), ANIMAX_K(0),
+      ANIMAX_K(0.08), ANIMAX_K(0.08), ANIMAX_K(0.08),
+      ANIMAX_K(0), ANIMAX_K(0), ANIMAX_K(0),
+      ANIMAX_K(0), 0, 0, ANIMAX_PERLIN,
+      {ANIMAX_FEED(1, 1.f / 50), ANIMAX_FEED(0, 1.f / 100), ANIMAX_NO_FEED, ANIMAX_NO_FEED} },
+  },
+  { ANIMAX_CH(0, 0, 1, 0, 0),
+    ANIMAX_CH_PROD(1.f / 255, 2, 3, 0),
+    ANIMAX_CH(0, 0, 0, 0, 0),
+    0, 0, 0, 0 },
+};
+
+static const AnimaxDesc animaxSpiralus = {
+  {0.0011, ANIMAX_DEFAULT_OFFSETS, {1.5, 2.3, 3, 0.05, 0.2, 0.03, 0.025, 0.021, 0.027, 10}},
+  3,
+  {
+    { 2, ANIMAX_DIST_LINEAR, ANIMAX_K(1),
+      ANIMAX_M(1, ANIMAX_NOISE(5)), ANIMAX_K(0), ANIMAX_MM(0.1, ANIMAX_DIR(3), ANIMAX_NOISE(6)),
+      ANIMAX_K(0.08), ANIMAX_K(0.08), ANIMAX_K(0.02),
+      ANIMAX_K(0), ANIMAX_M(-1, ANIMAX_LIN(0)), ANIMAX_K(0),
+      ANIMAX_M(1, ANIMAX_LIN(1)), 0, 0, ANIMAX_PERLIN,
+      ANIMAX_NO_FEEDS },
+    { 2, ANIMAX_DIST_LINEAR, ANIMAX_K(1),
+      ANIMAX_M(1, ANIMAX_NOISE(7)), ANIMAX_K(0), ANIMAX_MM(0.1, ANIMAX_DIR(5), ANIMAX_NOISE(8)),
+      ANIMAX_K(0.08), ANIMAX_K(0.08), ANIMAX_K(0.02),
+      ANIMAX_K(0), ANIMAX_M(-1, ANIMAX_LIN(1)), ANIMAX_K(0),
+      ANIMAX_M(1, ANIMAX_LIN(2)), 0, 0, ANIMAX_PERLIN,
+      ANIMAX_NO_FEEDS },
+    { 2, ANIMAX_DIST_LINEAR, ANIMAX_K(1),
+      ANIMAX_M(1, ANIMAX_NOISE(6)), ANIMAX_K(0), ANIMAX_MM(0.1, ANIMAX_DIR(6), ANIMAX_NOISE(7)),
+      ANIMAX_K(0.08), ANIMAX_K(0.08), ANIMAX_K(0.02),
+      ANIMAX_K(0), ANIMAX_M(1, ANIMAX_LIN(2)), ANIMAX_K(0),
+      ANIMAX_M(1, ANIMAX_LIN(0)), 0, 0, ANIMAX_PERLIN,
+      ANIMAX_NO_FEEDS },
+  },
+  { ANIMAX_CH(1, 1, 0, 0, ANIMAX_MASK_FADE),
+    ANIMAX_CH(1, -1, 0, 0, ANIMAX_MASK_FADE),
+    ANIMAX_CH(-1, 0, 1, 0, ANIMAX_MASK_FADE),
+    20, 0, 0, 0 },
+};
+
+static const AnimaxDesc animaxSpiralus2 = {
+  {0.0011, ANIMAX_DEFAULT_OFFSETS, {1.5, 2.3, 3, 0.05, 0.2, 0.03, 0.025, 0.021, 0.027, 10}},
+  3,
+  {
+    { 2, ANIMAX_DIST_LINEAR, ANIMAX_K(1),
+      ANIMAX_M(1, ANIMAX_NOISE(5)), ANIMAX_K(0), ANIMAX_MM(0.1, ANIMAX_DIR(3), ANIMAX_NOISE(6)),
+      ANIMAX_K(0.08), ANIMAX_K(0.08), ANIMAX_K(0.02),
+      ANIMAX_K(0), ANIMAX_M(-1, ANIMAX_LIN(0)), ANIMAX_K(0),
+      ANIMAX_M(1, ANIMAX_LIN(1)), 0, 0, ANIMAX_PERLIN,
+      ANIMAX_NO_FEEDS },
+    { 3, ANIMAX_DIST_LINEAR, ANIMAX_K(1),
+      ANIMAX_M(1, ANIMAX_NOISE(7)), ANIMAX_K(0), ANIMAX_MM(0.1, ANIMAX_DIR(5), ANIMAX_NOISE(8)),
+      ANIMAX_K(0.08), ANIMAX_K(0.08), ANIMAX_K(0.02),
+      ANIMAX_K(0), ANIMAX_M(-1, ANIMAX_LIN(1)), ANIMAX_K(0),
+      ANIMAX_M(1, ANIMAX_LIN(2)), 0, 0, ANIMAX_PERLIN,
+      ANIMAX_NO_FEEDS },
+    { 4, ANIMAX_DIST_LINEAR, ANIMAX_K(0.8),
+      ANIMAX_M(1, ANIMAX_NOISE(6)), ANIMAX_K(0), ANIMAX_MM(0.1, ANIMAX_DIR(6), ANIMAX_NOISE(7)),
+      ANIMAX_K(0.08), ANIMAX_K(0.08), ANIMAX_K(0.02),
+      ANIMAX_K(0), ANIMAX_M(1, ANIMAX_LIN(2)), ANIMAX_K(0),
+      ANIMAX_M(1, ANIMAX_LIN(0)), 0, 0, ANIMAX_PERLIN,
+      ANIMAX_NO_FEEDS },
+  },
+  { ANIMAX_CH(1, 1, 0, 0, ANIMAX_MASK_FADE),
+    ANIMAX_CH(1, -1, 0, 0, ANIMAX_MASK_FADE),
+    ANIMAX_CH(-1, 0, 1, 0, ANIMAX_MASK_FADE),
+    20, 0, 0, 0 },
+};
+
+static const AnimaxDesc animaxHotBlob = {
+  {0.005, ANIMAX_DEFAULT_OFFSETS, ANIMAX_DEFAULT_RATIOS},
+  4,
+  {
+    { 1, ANIMAX_DIST_LINEAR, ANIMAX_K(1),
+      ANIMAX_K(0), ANIMAX_K(0), ANIMAX_K(0),
+      ANIMAX_KM(0.07, 0.002, ANIMAX_DIR(0)), ANIMAX_K(0.07), ANIMAX_K(0.1),
+      ANIMAX_K(0), ANIMAX_M(-1, ANIMAX_LIN(0)), ANIMAX_K(0),
+      ANIMAX_K(0), 0, -1, ANIMAX_PERLIN,
+      ANIMAX_NO_FEEDS },
+    { 1, ANIMAX_DIST_LINEAR, ANIMAX_K(1),
+      ANIMAX_K(0), ANIMAX_K(0), ANIMAX_K(0),
+      ANIMAX_KM(0.07, 0.002, ANIMAX_DIR(0)), ANIMAX_K(0.07), ANIMAX_K(0.1),
+      ANIMAX_K(0), ANIMAX_M(-1, ANIMAX_LIN(1)), ANIMAX_K(0),
+      ANIMAX_K(0), 0, -1, ANIMAX_PERLIN,
+      ANIMAX_NO_FEEDS },
+    { 1, ANIMAX_DIST_LINEAR, ANIMAX_K(1),
+      ANIMAX_K(0), ANIMAX_K(0), ANIMAX_K(0),
+      ANIMAX_KM(0.07, 0.002, ANIMAX_DIR(0)), ANIMAX_K(0.07), ANIMAX_K(0.1),
+      ANIMAX_K(0), ANIMAX_M(-0.5, ANIMAX_LIN(0)), ANIMAX_K(0),
+      ANIMAX_K(0), 0, 0, ANIMAX_PERLIN,
+      {ANIMAX_NO_FEED, ANIMAX_NO_FEED, ANIMAX_FEED(1, 1.f / 20), ANIMAX_FEED(0, 1.f / 70)} },
+    { 1, ANIMAX_DIST_LINEAR, ANIMAX_K(1),
+      ANIMAX_K(0), ANIMAX_K(0), ANIMAX_K(0),
+      ANIMAX_KM(0.07, 0.002, ANIMAX_DIR(0)), ANIMAX_K(0.07), ANIMAX_K(0.1),
+      ANIMAX_K(0), ANIMAX_M(-0.5, ANIMAX_LIN(0)), ANIMAX_K(0),
+      ANIMAX_K(100), 0, 0, ANIMAX_PERLIN,
+      {ANIMAX_NO_FEED, ANIMAX_NO_FEED, ANIMAX_FEED(1, 1.f / 20), ANIMAX_FEED(0, 1.f / 70)} },
+  },
+  { ANIMAX_CH(0, 0, 1, 0, ANIMAX_MASK_BLOB),       // radial brightness filter
+    ANIMAX_CH(0, 0, 0.3, -0.3, ANIMAX_MASK_BLOB | ANIMAX_MASK_ROW),
+    ANIMAX_CH(0, 0, 0, 0, 0),
+    11, 1, LEDI_HEIGHT - 1, 0 },
+};
+
+static const AnimaxDesc animaxZoom = {
+  {0.003, ANIMAX_DEFAULT_OFFSETS, ANIMAX_DEFAULT_RATIOS},
+  1,
+  {
+    { 1, ANIMAX_DIST_SQUARE, ANIMAX_K(1),
+      ANIMAX_K(0), ANIMAX_K(0), ANIMAX_K(0),
+      ANIMAX_K(0.01), ANIMAX_K(0.01), ANIMAX_K(0.1),
+      ANIMAX_K(0), ANIMAX_M(-10, ANIMAX_LIN(0)), ANIMAX_K(0),
+      ANIMAX_K(0), 0, 0, ANIMAX_PERLIN,
+      ANIMAX_NO_FEEDS },
+  },
+  { ANIMAX_CH(1, 0, 0, 0, ANIMAX_MASK_ROW),
+    ANIMAX_CH(0, 0, 0, 0, 0),
+    ANIMAX_CH(0, 0, 0, 0, 0),
+    0, 1, LEDI_HEIGHT - 1, 0 },
+};
+
+static const AnimaxDesc animaxRings = {
+  {0.01, ANIMAX_DEFAULT_OFFSETS, {1, 1.1, 1.2, 4, 5, 6, 7, 8, 9, 10}},
+  3,
+  {
+    { 0, ANIMAX_DIST_LINEAR, ANIMAX_K(1),
+      ANIMAX_K(5), ANIMAX_K(0), ANIMAX_K(0),
+      ANIMAX_K(0.2), ANIMAX_K(0.2), ANIMAX_K(1),
+      ANIMAX_K(0), ANIMAX_M(-1, ANIMAX_LIN(0)), ANIMAX_K(0),
+      ANIMAX_K(0), 0, 0, ANIMAX_PERLIN,
+      ANIMAX_NO_FEEDS },
+    { 0, ANIMAX_DIST_LINEAR, ANIMAX_K(1),
+      ANIMAX_K(10), ANIMAX_K(0), ANIMAX_K(0),
+      ANIMAX_K(0.2), ANIMAX_K(0.2), ANIMAX_K(1),
+      ANIMAX_K(0), ANIMAX_M(-1, ANIMAX_LIN(1)), ANIMAX_K(0),
+      ANIMAX_K(0), 0, 0, ANIMAX_PERLIN,
+      ANIMAX_NO_FEEDS },
+    { 0, ANIMAX_DIST_LINEAR, ANIMAX_K(1),
+      ANIMAX_K(12), ANIMAX_K(0), ANIMAX_K(0),
+      ANIMAX_K(0.2), ANIMAX_K(0.2), ANIMAX_K(1),
+      ANIMAX_K(0), ANIMAX_M(-1, ANIMAX_LIN(2)), ANIMAX_K(0),
+      ANIMAX_K(0), 0, 0, ANIMAX_PERLIN,
+      ANIMAX_NO_FEEDS },
+  },
+  { ANIMAX_CH(1, 0, 0, 0, 0),
+    ANIMAX_CH(0, 0.25, 0, 0, 0),
+    ANIMAX_CH(0, 0, 0.25, 0, 0),
+    0, 0, 0, 0 },
+};
+
+static const AnimaxDesc animaxWaves = {
+  {0.01, ANIMAX_DEFAULT_OFFSETS, {2, 2.1, 1.2, 4, 5, 6, 7, 8, 9, 10}},
+  2,
+  {
+    { 1, ANIMAX_DIST_LINEAR, ANIMAX_K(1),
+      ANIMAX_K(0), ANIMAX_K(0), ANIMAX_K(0),
+      ANIMAX_K(0.1), ANIMAX_K(0.1), ANIMAX_K(0.1),
+      ANIMAX_K(0), ANIMAX_K(0), ANIMAX_K(0),
+      ANIMAX_M(-1, ANIMAX_LIN(0)), 2, 0, ANIMAX_PERLIN,
+      ANIMAX_NO_FEEDS },
+    { 1, ANIMAX_DIST_LINEAR, ANIMAX_K(1),
+      ANIMAX_K(0), ANIMAX_K(0), ANIMAX_K(0),
+      ANIMAX_K(0.1), ANIMAX_K(0.1), ANIMAX_K(0.1),
+      ANIMAX_K(0), ANIMAX_K(0), ANIMAX_K(0),
+      ANIMAX_M(-1, ANIMAX_LIN(1)), 2, 0, ANIMAX_PERLIN,
+      ANIMAX_NO_FEEDS },
+  },
+  { ANIMAX_CH(1, 0, 0, 0, 0),
+    ANIMAX_CH(0, 0, 0, 0, 0),
+    ANIMAX_CH(0, 1, 0, 0, 0),
+    0, 0, 0, 0 },
+};
+
+static const AnimaxDesc animaxCenterField = {
+  {0.01, ANIMAX_DEFAULT_OFFSETS, {1, 1.1, 1.2, 4, 5, 6, 7, 8, 9, 10}},
+  2,
+  {
+    { 1, ANIMAX_DIST_SQRT, ANIMAX_K(5),
+      ANIMAX_K(0), ANIMAX_K(0), ANIMAX_K(0),
+      ANIMAX_K(0.07), ANIMAX_K(0.07), ANIMAX_K(0.1),
+      ANIMAX_K(0), ANIMAX_M(1, ANIMAX_LIN(0)), ANIMAX_K(0),
+      ANIMAX_K(0), 0, 0, ANIMAX_PERLIN,
+      ANIMAX_NO_FEEDS },
+    { 1, ANIMAX_DIST_SQRT, ANIMAX_K(4),
+      ANIMAX_K(0), ANIMAX_K(0), ANIMAX_K(0),
+      ANIMAX_K(0.07), ANIMAX_K(0.07), ANIMAX_K(0.1),
+      ANIMAX_K(0), ANIMAX_M(1, ANIMAX_LIN(0)), ANIMAX_K(0),
+      ANIMAX_K(0), 0, 0, ANIMAX_PERLIN,
+      ANIMAX_NO_FEEDS },
+  },
+  { ANIMAX_CH(1, 0, 0, 0, 0),
+    ANIMAX_CH(0, 1, 0, 0, 0),
+    ANIMAX_CH(0, 0, 0, 0, 0),
+    0, 0, 0, 0 },
 };
 
 /* --------------------------------------------------------------------------------------------
  *  PROTOTYPES
  * --------------------------------------------------------------------------------------------
  */
-static void AnimaxCalculateOscillators(Oscillators &Timings);
-static float AnimaxRenderValue(RenderParameters &Animation);
-static void AnimaxRenderPolarLookupTable(float cx, float cy);
-static float AnimaxMapFloat(float x, float in_min, float in_max, float out_min, float out_max);
-static AnimaxRgb AnimaxRgbSanityCheck(AnimaxRgb &Pixel);
+static void AnimaxRender(AniParms *Ap, const AnimaxDesc &Desc);
+static void AnimaxCalculateOscillators(AnimaxCtx &Ctx, uint32_t Ms);
+static void AnimaxBindLayers(AnimaxCtx &Ctx, const AnimaxDesc &Desc);
+static float AnimaxBindValue(const Modulators &Move, const AnimaxBind &Bind);
+static inline float AnimaxModValue(const Modulators &Move, AnimaxMod Mod);
+static void AnimaxDecodeRow(const AnimaxGrid &Grid, uint16_t X, uint16_t Y, uint16_t Count,
+                            AnimaxRow &Row);
+static void AnimaxRowPlanes(const AnimaxPlanes *Planes, uint32_t PixNum, AnimaxRow &Row);
+static void AnimaxWarmup(AnimaxCtx &Ctx, const AnimaxDesc &Desc);
+static void AnimaxCooldown(AnimaxCtx &Ctx);
+static float AnimaxSupportRadius(const AnimaxDesc &Desc);
+static bool AnimaxPlanKeyframe(AnimaxCtx &Ctx, AniParms *Ap, const AnimaxDesc &Desc,
+                               uint32_t Now);
+static void AnimaxKeyframeRow(AnimaxCtx &Ctx, float (*Show)[LEDI_WIDTH], uint32_t PixNum,
+                              uint16_t First, uint16_t Count, float Mix);
+static void AnimaxHoldRow(AnimaxCtx &Ctx, const AnimaxDesc &Desc, float (*Show)[LEDI_WIDTH],
+                          uint32_t PixNum, uint16_t First, uint16_t Count);
+static uint8_t AnimaxFold(const AnimaxDesc &Desc);
+static bool AnimaxPolarLayout(AnimaxCtx &Ctx, const AnimaxDesc &Desc, uint8_t Fold);
+static void AnimaxRenderPolar(AnimaxCtx &Ctx, AnimaxRow &Row, float (*Show)[LEDI_WIDTH]);
+static void AnimaxResamplePolar(const AnimaxPolar &Polar, uint8_t NumLayers,
+                                const AnimaxRow &Row, float (*Show)[LEDI_WIDTH],
+                                uint16_t First, uint16_t Count);
+static inline float AnimaxPolarTap(const AnimaxPolar &Polar, uint8_t Layer, uint16_t Ring,
+                                   float Theta);
+static void AnimaxRenderLayer(AnimaxCtx &Ctx, const AnimaxFrameLayer &Layer,
+                              const AnimaxRow &Row, float (*Show)[LEDI_WIDTH], float *Out,
+                              uint16_t First, uint16_t Count);
+template <uint8_t AngleMode, bool FeedXY>
+static void AnimaxRenderLayerT(AnimaxCtx &Ctx, const AnimaxFrameLayer &Layer,
+                               const AnimaxRow &Row, float (*Show)[LEDI_WIDTH], float *Out,
+                               uint16_t First, uint16_t Count);
+static inline void AnimaxAddFeed(float *Dst, const AnimaxFeed &Feed, float (*Show)[LEDI_WIDTH],
+                                 uint16_t Base, uint16_t Count);
+static void AnimaxColormapRow(AnimaxCtx &Ctx, AniParms *Ap, const AnimaxDesc &Desc,
+                              float (*Show)[LEDI_WIDTH], const AnimaxRow &Row,
+                              const uint8_t *Writable, uint16_t Y, uint32_t PixNum,
+                              uint16_t First, uint16_t Last, uint16_t Count);
+static void AnimaxChannelRow(const AnimaxChannel &Ch, const AnimaxColormap &Cm,
+                             uint8_t NumLayers, float (*Show)[LEDI_WIDTH], const AnimaxRow &Row,
+                             float RowMask, const float *Mask, float *Out, uint16_t First,
+                             uint16_t Count);
+static inline void AnimaxAngleMultiple(float &CosA, float &SinA, uint8_t K);
+static void AnimaxNoiseRowQ16(const float *X, const float *Y, const float *Z, float *Out,
+                              uint16_t Count);
+#if ANIMAX_DIAGNOSTICS
+static void AnimaxCheckPolarTables(void);
+#endif /* ANIMAX_DIAGNOSTICS */
+static void AnimaxBeginFrame(AnimaxCtx &Ctx, AniParms *Ap, const AnimaxDesc &Desc);
+static uint8_t AnimaxMaxLevel(AniParms *Ap, const AnimaxDesc &Desc);
+static void AnimaxAdapt(AnimaxCtx &Ctx, AniParms *Ap, const AnimaxDesc &Desc,
+                        uint32_t RenderUs);
+static void AnimaxMarkVisible(AnimaxCtx &Ctx);
+static void AnimaxEndFrame(AnimaxCtx &Ctx, AniParms *Ap);
+
+/* --------------------------------------------------------------------------------------------
+ *  INLINE FUNCTIONS
+ * --------------------------------------------------------------------------------------------
+ */
+
+/* --------------------------------------------------------------------------------------------
+ *                 AnimaxForEachSpan()
+ * --------------------------------------------------------------------------------------------
+ * Description:    ANI_ForEachSpan() over the sample grid picked by AnimaxBeginFrame(). At
+ *                 full quality this is the frame itself.
+ *
+ * Parameters:     Ctx - Render context of the animation
+ *                 Body - Called as Body(uint16_t X, uint16_t Y, uint32_t PixNum, uint16_t Count)
+ *                     for the Count samples starting at PixNum in the grid tables. X and Y are
+ *                     the frame coordinates of the top left pixel of the first sample's block
+ *
+ * Returns:        void
+ */
+template <typename SpanBody>
+static inline void AnimaxForEachSpan(AnimaxCtx &Ctx, SpanBody &&Body)
+{
+    const AnimaxGrid &grid = *Ctx.grid;
+    uint16_t tx, ty, y, yEnd, count;
+
+    for (ty = 0; ty < grid.height; ty += ANIMAX_TILE_HEIGHT) {
+        yEnd = (ty + ANIMAX_TILE_HEIGHT < grid.height) ? ty + ANIMAX_TILE_HEIGHT : grid.height;
+        for (tx = 0; tx < grid.width; tx += ANIMAX_TILE_WIDTH) {
+            count = (tx + ANIMAX_TILE_WIDTH < grid.width) ? ANIMAX_TILE_WIDTH : grid.width - tx;
+            for (y = ty; y < yEnd; y++) {
+                Body((uint16_t)(tx << grid.shift), (uint16_t)(y << grid.shift),
+                     (uint32_t)y * grid.width + tx, count);
+            }
+        }
+    }
+}
+
+/* --------------------------------------------------------------------------------------------
+ *                 AnimaxForEachRowPair()
+ * --------------------------------------------------------------------------------------------
+ * Description:    Walks the sample grid picked by AnimaxBeginFrame() a full row at a time, in
+ *                 pairs of rows mirrored about the center: row 0, the last row, row 1, the
+ *                 row before the last and so on. The grid must have an even number of rows.
+ *
+ * Parameters:     Ctx - Render context of the animation
+ *                 Body - Called like the Body of AnimaxForEachSpan()
+ *
+ * Returns:        void
+ */
+template <typename SpanBody>
+static inline void AnimaxForEachRowPair(AnimaxCtx &Ctx, SpanBody &&Body)
+{
+    const AnimaxGrid &grid = *Ctx.grid;
+    uint16_t y, twin;
+
+    for (y = 0; y < grid.height / 2; y++) {
+        twin = grid.height - 1 - y;
+        Body((uint16_t)0, (uint16_t)(y << grid.shift), (uint32_t)y * grid.width, grid.width);
+        Body((uint16_t)0, (uint16_t)(twin << grid.shift), (uint32_t)twin * grid.width,
+             grid.width);
+    }
+}
+
+/* Saturates a color channel to 0..255 and truncates it to 8 bit. NaN comes out as 0 */
+static inline uint8_t AnimaxSat8(float V)
+{
+    V = (V > 0) ? V : 0;
+    V = (V < 255) ? V : 255;
+    return (uint8_t)(int32_t)V;
+}
+
+/* --------------------------------------------------------------------------------------------
+ *  PUBLIC FUNCTIONS
+ * --------------------------------------------------------------------------------------------
+ */
+
+/* --------------------------------------------------------------------------------------------
+ *                 ANIMAX_Init()
+ * --------------------------------------------------------------------------------------------
+ * Description:    Initializes this layer. Must be the very first function to be called and
+ *                 only call once or you can crash the system!
+ *
+ * Parameters:     None
+ *
+ * Returns:        true if successful. false otherwise.
+ */
+bool ANIMAX_Init()
+{
+    if (!ANOISE_VolumeInit()) {
+        return false;
+    }
+
+    // animations render without their planes when there is no arena
+    if (ANIMAX_ARENA_SIZE > 0) {
+        animaxArena.base = (uint8_t*)malloc(ANIMAX_ARENA_SIZE);
+        if (animaxArena.base == 0) {
+            Serial.println("Could not allocate memory for animatrix arena");
+        }
+    }
+
+#if ANOISE_DIAGNOSTICS
+    ANOISE_ReportAccuracy(100000);
+    ANOISE_ReportFbm(20000);
+    ANOISE_ReportSimplex();
+#endif /* ANOISE_DIAGNOSTICS */
+
+#if ANIMAX_DIAGNOSTICS
+    AnimaxCheckPolarTables();
+#endif /* ANIMAX_DIAGNOSTICS */
+
+    return true;
+}
+
+/* --------------------------------------------------------------------------------------------
+ *                 ANIMAX_CreateCtx()
+ * --------------------------------------------------------------------------------------------
+ * Description:    Allocates a render context for an ANIMAX animation. Store it in the
+ *                 p.animax.ctx field of the AniParms of the AniPack playing the animation.
+ *                 Each AniPack needs its own context.
+ *
+ * Parameters:     None
+ *
+ * Returns:        The new context. 0 if out of memory
+ */
+AnimaxCtx *ANIMAX_CreateCtx()
+{
+    AnimaxCtx *ctx = (AnimaxCtx*)calloc(1, sizeof(AnimaxCtx));
+    if (ctx == 0) {
+        Serial.println("Could not allocate memory for animatrix context");
+        return 0;
+    }
+
+    return ctx;
+}
+
+/* --------------------------------------------------------------------------------------------
+ *                 ANIMAX_Lava1() ... ANIMAX_CenterField()
+ * --------------------------------------------------------------------------------------------
+ * Description:    The ANIMartRIX animations. Each one renders its AnimaxDesc from the
+ *                 ANIMATIONS section, so a new animation is an AnimaxDesc and a function
+ *                 like these.
+ *
+ * Parameters:     Ap - AniParms of the AniPack playing the animation. p.animax.ctx must be
+ *                      set by ANIMAX_CreateCtx()
+ *
+ * Returns:        void
+ */
+void ANIMAX_Lava1(AniParms *Ap)
+{
+  AnimaxRender(Ap, animaxLava1);
+}
+
+void ANIMAX_ChasingSpirals(AniParms *Ap)
+{
+  AnimaxRender(Ap, animaxChasingSpirals);
+}
+
+void ANIMAX_Caleido1(AniParms *Ap)
+{
+  AnimaxRender(Ap, animaxCaleido1);
+}
+
+void ANIMAX_Caleido2(AniParms *Ap)
+{
+  AnimaxRender(Ap, animaxCaleido2);
+}
+
+void ANIMAX_Caleido3(AniParms *Ap)
+{
+  AnimaxRender(Ap, animaxCaleido3);
+}
+
+void ANIMAX_Scaledemo1(AniParms *Ap)
+{
+  AnimaxRender(Ap, animaxScaledemo1);
+}
+
+void ANIMAX_Yves(AniParms *Ap)
+{
+  AnimaxRender(Ap, animaxYves);
+}
+
+void ANIMAX_Spiralus(AniParms *Ap)
+{
+  AnimaxRender(Ap, animaxSpiralus);
+}
+
+void ANIMAX_Spiralus2(AniParms *Ap)
+{
+  AnimaxRender(Ap, animaxSpiralus2);
+}
+
+void Animax_HotBlob(AniParms *Ap)
+{
+  AnimaxRender(Ap, animaxHotBlob);
+}
+
+void ANIMAX_Zoom(AniParms *Ap)
+{
+  AnimaxRender(Ap, animaxZoom);
+}
+
+void ANIMAX_Rings(AniParms *Ap)
+{
+  AnimaxRender(Ap, animaxRings);
+}
+
+void ANIMAX_Waves(AniParms *Ap)
+{
+  AnimaxRender(Ap, animaxWaves);
+}
+
+void ANIMAX_CenterField(AniParms *Ap)
+{
+  AnimaxRender(Ap, animaxCenterField);
+}
+
+
+/* --------------------------------------------------------------------------------------------
+ *  PRIVATE FUNCTIONS
+ * --------------------------------------------------------------------------------------------
+ */
+
+
+void AnimaxCalculateOscillators(AnimaxCtx &Ctx, uint32_t Ms)
+{
+  Oscillators &Timings = Ctx.timings;
+  Modulators &move = Ctx.move;
+
+  double runtime = Ms * Timings.master_speed;  // global anaimation speed
+
+  for (int i = 0; i < NUM_OSCILLATORS; i++) {
+    
+    move.linear[i]      = (runtime + Timings.offset[i]) * Timings.ratio[i];     // continously rising offsets, returns              0 to max_float
+    
+    move.radial[i]      = fmodf(move.linear[i], 2 * PI);                        // angle offsets for continous rotation, returns    0 to 2 * PI
+    
+    move.directional[i] = sinf(move.radial[i]);                                 // directional offsets or factors, returns         -1 to 1
+    
+    move.noise_angle[i] = PI * (1 + ANOISE_Pnoise(move.linear[i], 0, 0));              // noise based angle offset, returns                0 to 2 * PI
+    
+  }
+}
+
+// Renders one frame of an animation. Everything that only changes once per frame is
+// evaluated up front by AnimaxBindLayers(), then every span of the grid is rendered
+// layer by layer and colormapped. Only the samples within the support radius of the
+// animation are rendered, the colormap paints the rest black. Samples of pixels a higher
+// layer owns are skipped altogether. Symmetric animations that allow it render their
+// layers on a polar wedge grid instead, the spans then resample it, except for the ones
+// that are the same turned by half a turn: those render the layers of the top half of
+// the grid and mirror them into the bottom half, which is exact. With a keyframe rate
+// the layers are only rendered for the keyframes, the frames in between blend them.
+// The warm-up call of ANI_SwapAnimation() only bakes the planes of the animation.
+// The cool-down call when it goes inactive only frees its buffers.
+
+void AnimaxRender(AniParms *Ap, const AnimaxDesc &Desc)
+{
+  AnimaxCtx *ctx = Ap->p.animax.ctx;
+  float show[ANIMAX_MAX_LAYERS][LEDI_WIDTH];
+  float mirrored[ANIMAX_MAX_LAYERS][LEDI_WIDTH];
+  uint8_t writableRow[LEDI_WIDTH];
+  uint8_t twinRow[LEDI_WIDTH];
+  uint8_t needRow[LEDI_WIDTH];
+  AnimaxRow row;
+  uint32_t start = micros();
+  uint32_t now = millis();
+  const AnimaxPlanes *planes;
+  float mix = 1;
+  bool polar = false, mirror = false, keyed, render;
+  uint8_t fold;
+
+  if (ctx == 0) {
+    return;
+  }
+  if (Ap->cooldown) {
+    AnimaxCooldown(*ctx);
+    return;
+  }
+
+  ctx->timings = Desc.timings;
+  AnimaxBeginFrame(*ctx, Ap, Desc);
+  if (Ap->warmup || ctx->planes.desc != &Desc || ctx->planes.grid != ctx->grid) {
+    AnimaxWarmup(*ctx, Desc);
+  }
+  if (Ap->warmup) {
+    return;
+  }
+  planes = (ctx->planes.epoch == animaxArena.epoch) ? &ctx->planes : 0;
+  ctx->support = AnimaxSupportRadius(Desc);
+  keyed = AnimaxPlanKeyframe(*ctx, Ap, Desc, now);
+  render = !keyed || ctx->keyDue;
+
+  if (keyed && ctx->keyMs[1] != ctx->keyMs[0]) {
+    mix = (float)(now - ctx->keyMs[0]) / (ctx->keyMs[1] - ctx->keyMs[0]);
+  }
+  if (render) {
+    // get linear movers and oscillators going
+    AnimaxCalculateOscillators(*ctx, keyed ? ctx->keyMs[1] : now);
+    AnimaxBindLayers(*ctx, Desc);
+
+    if (Ap->p.animax.polar) {
+      fold = AnimaxFold(Desc);
+      mirror = fold > 0 && (fold % 2) == 0 && (ctx->grid->height % 2) == 0;
+      polar = !mirror && AnimaxPolarLayout(*ctx, Desc, fold);
+    }
+    if (polar) {
+      AnimaxRenderPolar(*ctx, row, show);
+    }
+  }
+
+  auto span = [&](uint16_t x, uint16_t y, uint32_t pix, uint16_t n) {
+    const uint8_t *writable = writableRow;
+    const uint8_t *twinWritable = twinRow;
+    const uint8_t *need;
+    uint16_t first = 0, last = n, i, end;
+    uint16_t gy = y >> ctx->grid->shift;
+    uint32_t twin = (uint32_t)(ctx->grid->height - 1 - gy) * ctx->grid->width;
+    bool top = mirror && gy < ctx->grid->height / 2;
+    bool bottom = mirror && !top;
+    uint16_t numWritable = 1;
+
+    // a keyframe has every sample, whatever this frame may write
+    if (ctx->grid->shift != ANIMAX_QUALITY_FULL) {
+      writable = &ctx->visible[pix];
+      twinWritable = &ctx->visible[twin];
+    } else {
+      numWritable = ANI_WritableSpan(pix, n, writableRow);
+    }
+    if (numWritable == 0 && !ctx->keyDue && !top) {
+      return;
+    }
+
+    AnimaxDecodeRow(*ctx->grid, x >> ctx->grid->shift, y >> ctx->grid->shift, n, row);
+    AnimaxRowPlanes(planes, pix, row);
+
+    // the distance falls and rises along a span, so the
+    // samples within the support radius are one stretch
+    if (ctx->support > 0) {
+      while (first < last && row.dist[first] > ctx->support) {
+        first++;
+      }
+      while (last > first && row.dist[last - 1] > ctx->support) {
+        last--;
+      }
+    }
+
+    // the top row of a mirrored pair renders the samples of both rows
+    need = writable;
+    if (top && first < last) {
+      if (ctx->grid->shift == ANIMAX_QUALITY_FULL) {
+        numWritable += ANI_WritableSpan(twin, n, twinRow);
+      }
+      for (i = first; i < last; i++) {
+        needRow[i] = writable[i] | twinWritable[n - 1 - i];
+      }
+      need = needRow;
+    }
+    if (numWritable == 0 && !ctx->keyDue) {
+      return;
+    }
+
+    // render every stretch of writable samples in there, the bottom
+    // row of a mirrored pair takes the ones of the top row turned over
+    for (i = first; render && !bottom && i < last; i = end) {
+      while (i < last && !need[i] && !ctx->keyDue) {
+        i++;
+      }
+      for (end = i; end < last && (need[end] || ctx->keyDue); end++) {
+      }
+      if (polar) {
+        AnimaxResamplePolar(*ctx->polar, ctx->numLayers, row, show, i, end - i);
+        continue;
+      }
+      for (uint8_t l = 0; l < ctx->numLayers && i < end; l++) {
+        AnimaxRenderLayer(*ctx, ctx->layers[l], row, show, show[l], i, end - i);
+      }
+    }
+    for (uint8_t l = 0; l < ctx->numLayers && mirror && first < last; l++) {
+      if (top) {
+        for (i = first; i < last; i++) {
+          mirrored[l][n - 1 - i] = show[l][i];
+        }
+      } else {
+        memcpy(&show[l][first], &mirrored[l][first], (last - first) * sizeof(float));
+      }
+    }
+    if (keyed) {
+      AnimaxKeyframeRow(*ctx, show, pix, first, last - first, mix);
+    }
+    if (ctx->held != 0 && ctx->grid->shift == ANIMAX_QUALITY_QUARTER) {
+      AnimaxHoldRow(*ctx, Desc, show, pix, first, last - first);
+    }
+    AnimaxColormapRow(*ctx, Ap, Desc, show, row, writable, y, pix, first, last, n);
+  };
+
+  if (mirror) {
+    AnimaxForEachRowPair(*ctx, span);
+  } else {
+    AnimaxForEachSpan(*ctx, span);
+  }
+  AnimaxEndFrame(*ctx, Ap);
+  AnimaxAdapt(*ctx, Ap, Desc, micros() - start);
+  Ap->level = ctx->level;
+}
+
+// Radius past which every channel of the colormap is black, so the
+// layers needn't be rendered there. That is the cutoff if one is set,
+// else the mask radius when every channel that lights up is FADE or
+// BLOB masked with no negative weights: the layers never go below 0,
+// so such a channel is 0 or less once the mask turns negative.
+// 0 when the whole frame can light up
+
+float AnimaxSupportRadius(const AnimaxDesc &Desc)
+{
+  const AnimaxColormap &cm = Desc.colormap;
+  const AnimaxChannel *channels[] = {&cm.red, &cm.green, &cm.blue};
 
-static float AnimaxNoiseGrad(int hash, float x, float y, float z);
-static float AnimaxPnoise(float x, float y, float z);
-static void AnimaxRunDefaultOscillators();
-static void AnimaxReportPerformance();
+  if (cm.cutoff > 0) {
+    return cm.cutoff;
+  }
+  if (cm.radius <= 0) {
+    return 0;
+  }
 
-/* --------------------------------------------------------------------------------------------
- *  PUBLIC FUNCTIONS
- * --------------------------------------------------------------------------------------------
- */
+  for (const AnimaxChannel *ch : channels) {
+    bool lit = ch->prodK != 0;
+    bool negative = ch->prodK < 0;
 
-/* --------------------------------------------------------------------------------------------
- *                 ANIMAX_Init()
- * --------------------------------------------------------------------------------------------
- * Description:    Initializes this layer. Must be the very first function to be called and
- *                 only call once or you can crash the system!
- *
- * Parameters:     None
- *
- * Returns:        true if successful. false otherwise.
- */
-bool ANIMAX_Init()
-{
-    polar_theta = (float*)malloc(sizeof(float) * LEDI_NUM_LEDS);
-    if (polar_theta == 0) {
-        Serial.println("Could not allocate memory for animatrix");
-        return false;
+    for (uint8_t l = 0; l < Desc.numLayers; l++) {
+      lit |= ch->k[l] != 0;
+      negative |= ch->k[l] < 0;
     }
-    distance = (float*)malloc(sizeof(float) * LEDI_NUM_LEDS);
-    if (distance == 0) {
-        Serial.println("Could not allocate memory for animatrix");
-        return false;
+    if ((ch->masks & ANIMAX_MASK_ROW) && (cm.rowBias < 0 || cm.rowDiv < 0)) {
+      negative = true;
     }
+    if (lit && (negative || !(ch->masks & (ANIMAX_MASK_FADE | ANIMAX_MASK_BLOB)))) {
+      return 0;
+    }
+  }
+  return cm.radius;
+}
 
-    animation.center_x = (LEDI_WIDTH / 2) - 0.5;
-    animation.center_y = (LEDI_HEIGHT / 2) - 0.5;
-    animation.dist = 0;
-    animation.angle = 0;
-    animation.scale_x = 0.1;  // smaller values = zoom in
-    animation.scale_y = 0.1;
-    animation.scale_z = 0.1;       
-    animation.offset_x = 0;  
-    animation.offset_y = 0;
-    animation.offset_z = 0;
-    animation.low_limit  = 0; // getting contrast by highering the black point
-    animation.high_limit = 1;
+// Keyframe schedule of an animation with a keyframe rate. Once the
+// frame time passes the newer keyframe, the layers are rendered into
+// a new one a period further on, so every frame lies between the two
+// and nothing lags behind. Keyframes start over from a single one for
+// now when the animation, the grid or the layers change, or the frame
+// time is a whole period past the newer keyframe. false when the
+// animation renders its layers every frame
 
+bool AnimaxPlanKeyframe(AnimaxCtx &Ctx, AniParms *Ap, const AnimaxDesc &Desc, uint32_t Now)
+{
+  uint8_t hz = Ap->p.animax.keyframeHz;
+  uint32_t size = (uint32_t)Ctx.grid->width * Ctx.grid->height * Ctx.numLayers;
+  uint32_t period;
+
+  Ctx.keyDue = false;
+  if (hz == 0) {
+    Ctx.keyDesc = 0;
+    return false;
+  }
 
-    AnimaxRenderPolarLookupTable(animation.center_x, animation.center_y);
+  if (size > Ctx.keySize) {
+    free(Ctx.keys);
+    Ctx.keys = (uint16_t*)malloc(2 * size * sizeof(uint16_t));
+    Ctx.keySize = Ctx.keys ? size : 0;
+    Ctx.keyDesc = 0;
+    if (Ctx.keys == 0) {
+      Serial.println("Could not allocate memory for animatrix keyframes");
+      return false;
+    }
+  }
 
-    return true;
+  period = 1000 / hz;
+  if (Ctx.keyDesc != &Desc || Ctx.keyGrid != Ctx.grid || Ctx.keyLayers != Ctx.numLayers ||
+      (int32_t)(Now - Ctx.keyMs[1]) >= (int32_t)period) {
+    Ctx.keyDesc = &Desc;
+    Ctx.keyGrid = Ctx.grid;
+    Ctx.keyLayers = Ctx.numLayers;
+    Ctx.keyMs[0] = Now;
+    Ctx.keyMs[1] = Now;
+    Ctx.keyDue = true;
+  } else if ((int32_t)(Now - Ctx.keyMs[1]) >= 0) {
+    Ctx.keyMs[0] = Ctx.keyMs[1];
+    Ctx.keyMs[1] += period;
+    Ctx.keyDue = true;
+  }
+  if (Ctx.keyDue) {
+    Ctx.keyNew ^= 1;
+  }
+  return true;
 }
 
-/* --------------------------------------------------------------------------------------------
- *                 ANIMAX_Init()
- * --------------------------------------------------------------------------------------------
- * Description:    
- *
- * Parameters:     
- *
- * Returns:        void
- */
-void ANIMAX_Lava1(AniParms *Ap)
-{
-    uint16_t x, y;
-
-    timings.master_speed = 0.0015;    // speed ratios for the oscillators
-    timings.ratio[0] = 4;         // higher values = faster transitions
-    timings.ratio[1] = 1;
-    timings.ratio[2] = 1;
-    timings.ratio[3] = 0.05;
-    timings.ratio[4] = 0.6;
-    timings.offset[0] = 0;
-    timings.offset[1] = 100;
-    timings.offset[2] = 200;
-    timings.offset[3] = 300;
-    timings.offset[4] = 400;
-    
-    AnimaxCalculateOscillators(timings);     // get linear movers and oscillators going
-
-    for (x = 0; x < LEDI_WIDTH; x++) {
-      for (y = 0; y < LEDI_HEIGHT; y++) {
-    
-        // describe and render animation layers
-        animation.dist       = distance[pXY(x, y)] * 0.8;
-        animation.angle      = polar_theta[pXY(x, y)];
-        animation.scale_x    = 0.15;// + (move.directional[0] + 2)/100;
-        animation.scale_y    = 0.12;// + (move.directional[1] + 2)/100;
-        animation.scale_z    = 0.01;
-        animation.offset_y   = -move.linear[0];
-        animation.offset_x   = 0;
-        animation.offset_z   = 0;
-        animation.z          = 30;
-        float show1          = AnimaxRenderValue(animation);
-
-        animation.offset_y   = -move.linear[1];
-        animation.scale_x    = 0.15;// + (move.directional[0] + 2)/100;
-        animation.scale_y    = 0.12;// + (move.directional[1] + 2)/100;
-        animation.offset_x   = show1 / 100;
-        animation.offset_y   += show1/100;
-      
-        float show2          = AnimaxRenderValue(animation);
-
-        animation.offset_y   = -move.linear[2];
-        animation.scale_x    = 0.15;// + (move.directional[0] + 2)/100;
-        animation.scale_y    = 0.12;// + (move.directional[1] + 2)/100;
-        animation.offset_x   = show2 / 100;
-        animation.offset_y   += show2/100;
-      
-        float show3         = AnimaxRenderValue(animation);
-
-        // colormapping
-        float linear = (y)/(LEDI_HEIGHT-1.f);  // radial mask
-
-        pixel.red = linear*show2;
-        pixel.green = 0.1*linear*(show2-show3);
-        
-        pixel = AnimaxRgbSanityCheck(pixel);
-
-        ANI_WritePixel(Ap, pXY(x, y), CRGB(pixel.red, pixel.green, pixel.blue));
+// Stores the layers of a span rendered for a keyframe in the newer
+// keyframe, then blends the two keyframes into the span instead.
+// Mix is how far the frame is from the older to the newer one
 
+void AnimaxKeyframeRow(AnimaxCtx &Ctx, float (*Show)[LEDI_WIDTH], uint32_t PixNum,
+                       uint16_t First, uint16_t Count, float Mix)
+{
+  uint32_t stride = (uint32_t)Ctx.grid->width * Ctx.grid->height;
+  float wNew = Mix * (1.f / 256), wOld = (1 - Mix) * (1.f / 256);
+  uint16_t i;
+
+  for (uint8_t l = 0; l < Ctx.numLayers; l++) {
+    uint16_t *keyNew = &Ctx.keys[(Ctx.keyNew * Ctx.numLayers + l) * stride + PixNum + First];
+    uint16_t *keyOld = &Ctx.keys[((Ctx.keyNew ^ 1) * Ctx.numLayers + l) * stride + PixNum + First];
+    float *dst = &Show[l][First];
+
+    if (Ctx.keyDue) {
+      for (i = 0; i < Count; i++) {
+        keyNew[i] = (uint16_t)(dst[i] * 256 + 0.5f);
       }
     }
+    for (i = 0; i < Count; i++) {
+      dst[i] = keyOld[i] * wOld + keyNew[i] * wNew;
+    }
+  }
 }
 
-void ANIMAX_ChasingSpirals(AniParms *Ap) {
-
-  timings.master_speed = 0.01;    // speed ratios for the oscillators
-  timings.ratio[0] = 0.1;         // higher values = faster transitions
-  timings.ratio[1] = 0.13;
-  timings.ratio[2] = 0.16;
-  
-  timings.offset[1] = 10;
-  timings.offset[2] = 20;
-  timings.offset[3] = 30;
-  
-  AnimaxCalculateOscillators(timings);     // get linear movers and oscillators going
-
-  for (int x = 0; x < LEDI_WIDTH; x++) {
-    for (int y = 0; y < LEDI_HEIGHT; y++) {
-  
-      // describe and render animation layers
-      animation.angle      = 3 * polar_theta[pXY(x, y)] +  move.radial[0] - distance[pXY(x, y)]/3;
-      animation.dist       = distance[pXY(x, y)];
-      animation.scale_z    = 0.1;  
-      animation.scale_y    = 0.1;
-      animation.scale_x    = 0.1;
-      animation.offset_x   = move.linear[0];
-      animation.offset_y   = 0;
-      animation.offset_z   = 0;
-      animation.z          = 0;
-      float show1          = AnimaxRenderValue(animation);
-
-      animation.angle      = 3 * polar_theta[pXY(x, y)] +  move.radial[1] - distance[pXY(x, y)]/3;
-      animation.dist       = distance[pXY(x, y)];
-      animation.offset_x   = move.linear[1];
-      float show2          = AnimaxRenderValue(animation);
-
-      animation.angle      = 3 * polar_theta[pXY(x, y)] +  move.radial[2] - distance[pXY(x, y)]/3;
-      animation.dist       = distance[pXY(x, y)];
-      animation.offset_x   = move.linear[2];
-      float show3          = AnimaxRenderValue(animation);
-
-      // colormapping
-      float radius = 10;
-      float radial_filter = (radius - distance[pXY(x, y)]) / radius;
-
-      pixel.red   = 3*show1 * radial_filter;
-      pixel.green = show2 * radial_filter / 2;
-      pixel.blue  = show3 * radial_filter / 4;
-
-      pixel = AnimaxRgbSanityCheck(pixel);
-
-      ANI_WritePixel(Ap, pXY(x, y), CRGB(pixel.red, pixel.green, pixel.blue));
+// Stores the layers past the first of a row of the quarter grid as
+// they are shown, and puts the stored values back into the layers the
+// adaptive quality dropped. A dropped layer so holds still where it
+// was, rather than the colormap getting some other layer in its place
+
+void AnimaxHoldRow(AnimaxCtx &Ctx, const AnimaxDesc &Desc, float (*Show)[LEDI_WIDTH],
+                   uint32_t PixNum, uint16_t First, uint16_t Count)
+{
+  uint32_t stride = (uint32_t)Ctx.grid->width * Ctx.grid->height;
+  uint16_t i;
+
+  for (uint8_t l = 1; l < Desc.numLayers; l++) {
+    uint16_t *held = &Ctx.held[(l - 1) * stride + PixNum + First];
+    float *dst = &Show[l][First];
+
+    if (l < Ctx.numLayers) {
+      for (i = 0; i < Count; i++) {
+        held[i] = (uint16_t)(dst[i] * 256 + 0.5f);
+      }
+    } else {
+      for (i = 0; i < Count; i++) {
+        dst[i] = held[i] * (1.f / 256);
+      }
     }
   }
-
 }
 
-void ANIMAX_Caleido1(AniParms *Ap)
+// Fold of the symmetry of an animation, the greatest common divisor K
+// of the angle multiples of its layers. Every layer angle is then a
+// multiple of K * theta, so the animation repeats every 2 * PI / K
+// around the center. 0 when there is no angle term at all, 1 when
+// there is no symmetry
+
+uint8_t AnimaxFold(const AnimaxDesc &Desc)
 {
+  uint8_t k = 0, a, b, t;
 
-  timings.master_speed = 0.003;    // speed ratios for the oscillators
-  timings.ratio[0] = 0.02;         // higher values = faster transitions
-  timings.ratio[1] = 0.03;
-  timings.ratio[2] = 0.04;
-  timings.ratio[3] = 0.05;
-  timings.ratio[4] = 0.6;
-  timings.offset[0] = 0;
-  timings.offset[1] = 100;
-  timings.offset[2] = 200;
-  timings.offset[3] = 300;
-  timings.offset[4] = 400;
-  
-  AnimaxCalculateOscillators(timings);     // get linear movers and oscillators going
-
-  for (int x = 0; x < LEDI_WIDTH; x++) {
-    for (int y = 0; y < LEDI_HEIGHT; y++) {
-  
-      // describe and render animation layers
-      animation.dist       = distance[pXY(x, y)] * (2 + move.directional[0]) / 3;
-      animation.angle      = 3 * polar_theta[pXY(x, y)] + 3 * move.noise_angle[0] + move.radial[4];
-      animation.scale_x    = 0.1;
-      animation.scale_y    = 0.1;
-      animation.scale_z    = 0.1;
-      animation.offset_y   = 2 * move.linear[0];
-      animation.offset_x   = 0;
-      animation.offset_z   = 0;
-      animation.z          = move.linear[0];
-      float show1          = AnimaxRenderValue(animation);
-
-      animation.dist       = distance[pXY(x, y)] * (2 + move.directional[1]) / 3;
-      animation.angle      = 4 * polar_theta[pXY(x, y)] + 3 * move.noise_angle[1] + move.radial[4];
-      animation.offset_x   = 2 * move.linear[1];
-      animation.z          = move.linear[1];
-      float show2          = AnimaxRenderValue(animation);
-
-      animation.dist       = distance[pXY(x, y)] * (2 + move.directional[2]) / 3;
-      animation.angle      = 5 * polar_theta[pXY(x, y)] + 3 * move.noise_angle[2] + move.radial[4];
-      animation.offset_y   = 2 * move.linear[2];
-      animation.z          = move.linear[2];
-      float show3          = AnimaxRenderValue(animation);
-
-      animation.dist       = distance[pXY(x, y)] * (2 + move.directional[3]) / 3;
-      animation.angle      = 4 * polar_theta[pXY(x, y)] + 3 * move.noise_angle[3] + move.radial[4];
-      animation.offset_x   = 2 * move.linear[3];
-      animation.z          = move.linear[3];
-      float show4          = AnimaxRenderValue(animation);
-      
-      // colormapping
-      pixel.red   = show1;
-      pixel.green = show3 * distance[pXY(x, y)] / 10;
-      pixel.blue  = (show2 + show4) / 2;
-
-      pixel = AnimaxRgbSanityCheck(pixel);
-
-      ANI_WritePixel(Ap, pXY(x, y), CRGB(pixel.red, pixel.green, pixel.blue));
+  for (uint8_t l = 0; l < Desc.numLayers; l++) {
+    for (a = k, b = Desc.layers[l].angleMult; b != 0; a = t) {
+      t = b;
+      b = a % b;
     }
+    k = a;
   }
+  return k;
 }
 
-void ANIMAX_Caleido2(AniParms *Ap)
+// Lays out the polar wedge grid for this frame. Only used for radial
+// and odd Folds other than 1 when the wedge takes less than half the
+// samples of the cartesian grid, which leaves out animations with little
+// symmetry and the ones that are culled to a small radius anyway. Even
+// Folds are mirrored through the center instead, which is exact
+
+bool AnimaxPolarLayout(AnimaxCtx &Ctx, const AnimaxDesc &Desc, uint8_t Fold)
 {
+  const AnimaxGrid &grid = *Ctx.grid;
+  float step = (float)(1 << grid.shift) / ANIMAX_POLAR_OVERSAMPLE;
+  float maxDist, wedge;
+  uint32_t numSamples = 0, n;
+  uint16_t numRings, ring;
+  uint8_t k = Fold;
+
+  if (k == 1) {
+    return false;
+  }
+
+  maxDist = (Ctx.support > 0) ? Ctx.support : hypotf(ANIMAX_CENTER_X + 0.5f,
+                                                     ANIMAX_CENTER_Y + 0.5f);
+  numRings = (uint16_t)ceilf(maxDist / step) + 2;     // + the ring past the last sample
+  wedge = k ? 2 * PI / k : 0;
+  if (numRings > ANIMAX_POLAR_MAX_RINGS) {
+    return false;
+  }
+  for (ring = 0; ring < numRings; ring++) {
+    n = (uint32_t)ceilf(ring * wedge);
+    numSamples += n ? n : 1;
+  }
+  if (numSamples > ANIMAX_POLAR_MAX_SAMPLES ||
+      2 * numSamples >= (uint32_t)grid.width * grid.height) {
+    return false;
+  }
 
-  timings.master_speed = 0.002;    // speed ratios for the oscillators
-  timings.ratio[0] = 0.02;         // higher values = faster transitions
-  timings.ratio[1] = 0.03;
-  timings.ratio[2] = 0.04;
-  timings.ratio[3] = 0.05;
-  timings.ratio[4] = 0.6;
-  timings.offset[0] = 0;
-  timings.offset[1] = 100;
-  timings.offset[2] = 200;
-  timings.offset[3] = 300;
-  timings.offset[4] = 400;
-  
-  AnimaxCalculateOscillators(timings);     // get linear movers and oscillators going
-
-  for (int x = 0; x < LEDI_WIDTH; x++) {
-    for (int y = 0; y < LEDI_HEIGHT; y++) {
-  
-      // describe and render animation layers
-      animation.dist       = distance[pXY(x, y)] * (2 + move.directional[0]) / 3;
-      animation.angle      = 2 * polar_theta[pXY(x, y)] + 3 * move.noise_angle[0] + move.radial[4];
-      animation.scale_x    = 0.1;
-      animation.scale_y    = 0.1;
-      animation.scale_z    = 0.1;
-      animation.offset_y   = 2 * move.linear[0];
-      animation.offset_x   = 0;
-      animation.offset_z   = 0;
-      animation.z          = move.linear[0];
-      float show1          = AnimaxRenderValue(animation);
-
-      animation.dist       = distance[pXY(x, y)] * (2 + move.directional[1]) / 3;
-      animation.angle      = 2 * polar_theta[pXY(x, y)] + 3 * move.noise_angle[1] + move.radial[4];
-      animation.offset_x   = 2 * move.linear[1];
-      animation.z          = move.linear[1];
-      float show2          = AnimaxRenderValue(animation);
-
-      animation.dist       = distance[pXY(x, y)] * (2 + move.directional[2]) / 3;
-      animation.angle      = 2 * polar_theta[pXY(x, y)] + 3 * move.noise_angle[2] + move.radial[4];
-      animation.offset_y   = 2 * move.linear[2];
-      animation.z          = move.linear[2];
-      float show3          = AnimaxRenderValue(animation);
-
-      animation.dist       = distance[pXY(x, y)] * (2 + move.directional[3]) / 3;
-      animation.angle      = 2 * polar_theta[pXY(x, y)] + 3 * move.noise_angle[3] + move.radial[4];
-      animation.offset_x   = 2 * move.linear[3];
-      animation.z          = move.linear[3];
-      float show4          = AnimaxRenderValue(animation);
-      
-      // colormapping
-      pixel.red   = show1;
-      pixel.green = show3 * distance[pXY(x, y)] / 10;
-      pixel.blue  = (show2 + show4) / 2;
-
-      pixel = AnimaxRgbSanityCheck(pixel);
-
-      ANI_WritePixel(Ap, pXY(x, y), CRGB(pixel.red, pixel.green, pixel.blue));
+  if (Ctx.polar == 0) {
+    Ctx.polar = (AnimaxPolar*)malloc(sizeof(AnimaxPolar));
+    if (Ctx.polar == 0) {
+      Serial.println("Could not allocate memory for animatrix");
+      return false;
     }
   }
+
+  AnimaxPolar &polar = *Ctx.polar;
+
+  polar.wedge = wedge;
+  polar.step = step;
+  polar.numRings = numRings;
+  polar.ringStart[0] = 0;
+  for (ring = 0; ring < numRings; ring++) {
+    n = (uint32_t)ceilf(ring * wedge);
+    polar.ringStart[ring + 1] = polar.ringStart[ring] + (n ? n : 1);
+  }
+  return true;
 }
 
-void ANIMAX_Caleido3(AniParms *Ap)
+// Renders all layers on every ring of the polar wedge grid, in spans
+// of up to LEDI_WIDTH samples through the regular layer renderer
+
+void AnimaxRenderPolar(AnimaxCtx &Ctx, AnimaxRow &Row, float (*Show)[LEDI_WIDTH])
 {
+  AnimaxPolar &polar = *Ctx.polar;
 
-a = micros();                   // for time measurement in report_performance()
-
-  timings.master_speed = 0.004;    // speed ratios for the oscillators
-  timings.ratio[0] = 0.02;         // higher values = faster transitions
-  timings.ratio[1] = 0.03;
-  timings.ratio[2] = 0.04;
-  timings.ratio[3] = 0.05;
-  timings.ratio[4] = 0.6;
-  timings.offset[0] = 0;
-  timings.offset[1] = 100;
-  timings.offset[2] = 200;
-  timings.offset[3] = 300;
-  timings.offset[4] = 400;
-  
-  AnimaxCalculateOscillators(timings);     // get linear movers and oscillators going
-
-  for (int x = 0; x < LEDI_WIDTH; x++) {
-    for (int y = 0; y < LEDI_HEIGHT; y++) {
-  
-      // describe and render animation layers
-      animation.dist       = distance[pXY(x, y)] * (2 + move.directional[0]) / 3;
-      animation.angle      = 2 * polar_theta[pXY(x, y)] + 3 * move.noise_angle[0] + move.radial[4];
-      animation.scale_x    = 0.1;// + (move.directional[0] + 2)/100;
-      animation.scale_y    = 0.1;// + (move.directional[1] + 2)/100;
-      animation.scale_z    = 0.1;
-      animation.offset_y   = 2 * move.linear[0];
-      animation.offset_x   = 2 * move.linear[1];
-      animation.offset_z   = 0;
-      animation.z          = move.linear[0];
-      float show1          = AnimaxRenderValue(animation);
-
-      animation.dist       = distance[pXY(x, y)] * (2 + move.directional[1]) / 3;
-      animation.angle      = 2 * polar_theta[pXY(x, y)] + 3 * move.noise_angle[1] + move.radial[4];
-      animation.offset_x   = 2 * move.linear[1];
-      animation.offset_y   = show1 / 20.0;
-      animation.z          = move.linear[1];
-      float show2          = AnimaxRenderValue(animation);
-
-      animation.dist       = distance[pXY(x, y)] * (2 + move.directional[2]) / 3;
-      animation.angle      = 2 * polar_theta[pXY(x, y)] + 3 * move.noise_angle[2] + move.radial[4];
-      animation.offset_y   = 2 * move.linear[2];
-      animation.offset_x   = show2 / 20.0;
-      animation.z          = move.linear[2];
-      float show3          = AnimaxRenderValue(animation);
-
-      animation.dist       = distance[pXY(x, y)] * (2 + move.directional[3]) / 3;
-      animation.angle      = 2 * polar_theta[pXY(x, y)] + 3 * move.noise_angle[3] + move.radial[4];
-      animation.offset_x   = 2 * move.linear[3];
-      animation.offset_y   = show3 / 20.0;
-      animation.z          = move.linear[3];
-      float show4          = AnimaxRenderValue(animation);
-      
-      // colormapping
-      float radius = 8;  // radial mask
-
-      pixel.red   = show1 * (y+1) / LEDI_HEIGHT;
-      pixel.green = show3 * distance[pXY(x, y)] / 10;
-      pixel.blue  = (show2 + show4) / 2;
-      if (distance[pXY(x, y)] > radius) {
-        pixel.red = 0;
-        pixel.green = 0;
-        pixel.blue = 0;
-      }
+  AnimaxRowPlanes(0, 0, Row);
+  for (uint16_t ring = 0; ring < polar.numRings; ring++) {
+    uint16_t start = polar.ringStart[ring];
+    uint16_t size = polar.ringStart[ring + 1] - start;
+    float apart = polar.wedge / size;
 
-      pixel = AnimaxRgbSanityCheck(pixel);
+    for (uint16_t base = 0; base < size; base += LEDI_WIDTH) {
+      uint16_t n = min(size - base, LEDI_WIDTH);
 
-      ANI_WritePixel(Ap, pXY(x, y), CRGB(pixel.red, pixel.green, pixel.blue));
+      for (uint16_t i = 0; i < n; i++) {
+        float theta = (base + i) * apart;
+
+        Row.dist[i]     = ring * polar.step;
+        Row.theta[i]    = theta;
+        Row.cosTheta[i] = cosf(theta);
+        Row.sinTheta[i] = sinf(theta);
+      }
+      for (uint8_t l = 0; l < Ctx.numLayers; l++) {
+        AnimaxRenderLayer(Ctx, Ctx.layers[l], Row, Show, Show[l], 0, n);
+        memcpy(&polar.show[l][start + base], Show[l], n * sizeof(float));
+      }
     }
   }
 }
 
-void ANIMAX_Scaledemo1(AniParms *Ap)
+// Resamples the layers of the Count samples of a span from First on
+// from the polar wedge grid, linear between the two rings around a
+// sample and along each ring
+
+void AnimaxResamplePolar(const AnimaxPolar &Polar, uint8_t NumLayers, const AnimaxRow &Row,
+                         float (*Show)[LEDI_WIDTH], uint16_t First, uint16_t Count)
 {
+  float perStep = 1 / Polar.step;
 
+  for (uint16_t i = First; i < First + Count; i++) {
+    float r = Row.dist[i] * perStep;
+    uint16_t ring = (uint16_t)r;
+    float fr;
 
-  timings.master_speed = 0.00003;    // speed ratios for the oscillators
-  timings.ratio[0] = 4;         // higher values = faster transitions
-  timings.ratio[1] = 3.2;
-  timings.ratio[2] = 10;
-  timings.ratio[3] = 0.05;
-  timings.ratio[4] = 0.6;
-  timings.offset[0] = 0;
-  timings.offset[1] = 100;
-  timings.offset[2] = 200;
-  timings.offset[3] = 300;
-  timings.offset[4] = 400;
-  
-  AnimaxCalculateOscillators(timings);     // get linear movers and oscillators going
-
-  for (int x = 0; x < LEDI_WIDTH; x++) {
-    for (int y = 0; y < LEDI_HEIGHT; y++) {
-  
-      // describe and render animation layers
-      animation.dist       = 0.3*distance[pXY(x, y)] * 0.8;
-      animation.angle      = 3*polar_theta[pXY(x, y)] + move.radial[2];
-      animation.scale_x    = 0.1 + (move.noise_angle[0])/10;
-      animation.scale_y    = 0.1 + (move.noise_angle[1])/10;// + (move.directional[1] + 2)/100;
-      animation.scale_z    = 0.01;
-      animation.offset_y   = 0;
-      animation.offset_x   = 0;
-      animation.offset_z   = 100*move.linear[0];
-      animation.z          = 30;
-      float show1          = AnimaxRenderValue(animation);
-
-      animation.angle      = 3;
-      float show2          = AnimaxRenderValue(animation);
-
-      float dist = (10-distance[pXY(x, y)])/ 10;
-      pixel.red = show1*dist;
-      pixel.green = (show1-show2)*dist*0.3;
-      pixel.blue = (show2-show1)*dist;
-
-      if (distance[pXY(x, y)] > 8) {
-         pixel.red = 0;
-         pixel.green = 0;
-         pixel.blue = 0;
+    if (ring > Polar.numRings - 2) {
+      ring = Polar.numRings - 2;
+    }
+    fr = r - ring;
 
-      }
-      
-      pixel = AnimaxRgbSanityCheck(pixel);
+    for (uint8_t l = 0; l < NumLayers; l++) {
+      float v0 = AnimaxPolarTap(Polar, l, ring, Row.theta[i]);
+      float v1 = AnimaxPolarTap(Polar, l, ring + 1, Row.theta[i]);
 
-      ANI_WritePixel(Ap, pXY(x, y), CRGB(pixel.red, pixel.green, pixel.blue));
+      Show[l][i] = v0 + (v1 - v0) * fr;
     }
   }
-
 }
 
+// Value of a layer at angle Theta on a ring. The wedge repeats, so the
+// last sample of a ring blends into its first
 
-void ANIMAX_Yves(AniParms *Ap)
+float AnimaxPolarTap(const AnimaxPolar &Polar, uint8_t Layer, uint16_t Ring, float Theta)
 {
+  const float *show = &Polar.show[Layer][Polar.ringStart[Ring]];
+  uint16_t size = Polar.ringStart[Ring + 1] - Polar.ringStart[Ring];
+  float pos, f;
+  uint16_t j0, j1;
+
+  if (size == 1) {
+    return show[0];
+  }
 
+  pos = Theta / Polar.wedge;
+  pos = (pos - floorf(pos)) * size;
+  j0 = (uint16_t)pos;
+  f = pos - j0;
+  if (j0 >= size) {
+    j0 = 0;
+  }
+  j1 = (j0 + 1 < size) ? j0 + 1 : 0;
 
-  timings.master_speed = 0.001;    // speed ratios for the oscillators
-  timings.ratio[0] = 3;         // higher values = faster transitions
-  timings.ratio[1] = 2;
-  timings.ratio[2] = 1;
-  timings.ratio[3] = 0.13;
-  timings.ratio[4] = 0.15;
-  timings.ratio[5] = 0.03;
-  timings.ratio[6] = 0.025;
-  timings.offset[0] = 0;
-  timings.offset[1] = 100;
-  timings.offset[2] = 200;
-  timings.offset[3] = 300;
-  timings.offset[4] = 400;
-  timings.offset[5] = 500;
-  timings.offset[6] = 600;
-  
-  AnimaxCalculateOscillators(timings);     // get linear movers and oscillators going
-
-  for (int x = 0; x < LEDI_WIDTH; x++) {
-    for (int y = 0; y < LEDI_HEIGHT; y++) {
-      
-      animation.dist       = distance[pXY(x, y)] ;
-      animation.angle      = polar_theta[pXY(x, y)] + 2*PI + move.noise_angle[5];
-      animation.scale_x    = 0.08;
-      animation.scale_y    = 0.08;
-      animation.scale_z    = 0.08;
-      animation.offset_y   = -move.linear[0];
-      animation.offset_x   = 0;
-      animation.offset_z   = 0;
-      animation.z          = 0;
-      float show1          = AnimaxRenderValue(animation);
-
-      animation.dist       = distance[pXY(x, y)];
-      animation.angle      = polar_theta[pXY(x, y)] + 2*PI + move.noise_angle[6];;
-      animation.scale_x    = 0.08;
-      animation.scale_y    = 0.08;
-      animation.scale_z    = 0.08;
-      animation.offset_y   = -move.linear[1];
-      animation.offset_x   = 0;
-      animation.offset_z   = 0;
-      animation.z          = 0;
-      float show2          = AnimaxRenderValue(animation);
-
-      animation.angle      = polar_theta[pXY(x, y)] + show1/100 + move.noise_angle[3] + move.noise_angle[4];
-      animation.dist       = distance[pXY(x, y)] + show2/50;
-      animation.offset_y   = -move.linear[2];
-
-      animation.offset_y   += show1/100;
-      animation.offset_x   += show2/100;
-
-      float show3          = AnimaxRenderValue(animation);
-
-      animation.offset_y   = 0;
-      animation.offset_x   = 0;
-
-      float show4          = AnimaxRenderValue(animation);
-      
-     
-      pixel.red   = show3;
-      pixel.green = show3*show4/255;
-      pixel.blue  = 0;
-      
-      pixel = AnimaxRgbSanityCheck(pixel);
-      ANI_WritePixel(Ap, pXY(x, y), CRGB(pixel.red, pixel.green, pixel.blue));
-    }
+  return show[j0] + (show[j1] - show[j0]) * f;
+}
+
+// Mirrors the quadrant tables of the grid out to the Count samples
+// of row Y starting at X, all in grid coordinates. Left of the
+// center the angle is PI minus the stored one and the cosine flips,
+// above it angle and sine flip
+
+void AnimaxDecodeRow(const AnimaxGrid &Grid, uint16_t X, uint16_t Y, uint16_t Count,
+                     AnimaxRow &Row)
+{
+  uint16_t halfW = Grid.width / 2;
+  uint16_t halfH = Grid.height / 2;
+  bool above = Y < halfH;
+  uint32_t quad = (uint32_t)(above ? halfH - 1 - Y : Y - halfH) * halfW;
+  float signY = above ? -1.f : 1.f;
+
+  for (uint16_t i = 0; i < Count; i++) {
+    uint16_t x = X + i;
+    bool left = x < halfW;
+    uint32_t q = quad + (left ? halfW - 1 - x : x - halfW);
+    float theta = Grid.polar_theta[q] * (float)ANIMAX_ANGLE_LSB;
+    float cosT = Grid.cos_theta[q] * (float)ANIMAX_UNIT_LSB;
+
+    Row.dist[i]     = Grid.distance[q] * (float)ANIMAX_DIST_LSB;
+    Row.theta[i]    = signY * (left ? PI - theta : theta);
+    Row.cosTheta[i] = left ? -cosT : cosT;
+    Row.sinTheta[i] = signY * Grid.sin_theta[q] * (float)ANIMAX_UNIT_LSB;
   }
 }
 
-void ANIMAX_Spiralus(AniParms *Ap)
+// Points the plane pointers of a span at sample PixNum of the planes,
+// or clears them when there are none
+
+void AnimaxRowPlanes(const AnimaxPlanes *Planes, uint32_t PixNum, AnimaxRow &Row)
 {
+  uint8_t i;
 
-  timings.master_speed = 0.0011;    // speed ratios for the oscillators
-  timings.ratio[0] = 1.5;         // higher values = faster transitions
-  timings.ratio[1] = 2.3;
-  timings.ratio[2] = 3;
-  timings.ratio[3] = 0.05;
-  timings.ratio[4] = 0.2;
-  timings.ratio[5] = 0.03;
-  timings.ratio[6] = 0.025;
-  timings.ratio[7] = 0.021;
-  timings.ratio[8] = 0.027;
-  timings.offset[0] = 0;
-  timings.offset[1] = 100;
-  timings.offset[2] = 200;
-  timings.offset[3] = 300;
-  timings.offset[4] = 400;
-  timings.offset[5] = 500;
-  timings.offset[6] = 600;
-  
-  AnimaxCalculateOscillators(timings);     // get linear movers and oscillators going
-
-  for (int x = 0; x < LEDI_WIDTH; x++) {
-    for (int y = 0; y < LEDI_HEIGHT; y++) {
-      
-      animation.dist       = distance[pXY(x, y)] ;
-      animation.angle      = 2*polar_theta[pXY(x, y)] + move.noise_angle[5] + move.directional[3] * move.noise_angle[6]* animation.dist/10;
-      animation.scale_x    = 0.08;
-      animation.scale_y    = 0.08;
-      animation.scale_z    = 0.02;
-      animation.offset_y   = -move.linear[0];
-      animation.offset_x   = 0;
-      animation.offset_z   = 0;
-      animation.z          = move.linear[1];
-      float show1          = AnimaxRenderValue(animation);
-
-      animation.angle      = 2*polar_theta[pXY(x, y)] + move.noise_angle[7] + move.directional[5] * move.noise_angle[8]* animation.dist/10;
-      animation.offset_y   = -move.linear[1];
-      animation.z          = move.linear[2];
-            
-      float show2          = AnimaxRenderValue(animation);
-
-      animation.angle      = 2*polar_theta[pXY(x, y)] + move.noise_angle[6] + move.directional[6] * move.noise_angle[7]* animation.dist/10;
-      animation.offset_y   = move.linear[2];
-      animation.z          = move.linear[0];
-      float show3          = AnimaxRenderValue(animation);
-      
-      
-      float f =  (20-distance[pXY(x, y)])/20;
-     
-      pixel.red   = f*(show1+show2);
-      pixel.green = f*(show1-show2);
-      pixel.blue  = f*(show3-show1);
-      
-      pixel = AnimaxRgbSanityCheck(pixel);
-      ANI_WritePixel(Ap, pXY(x, y), CRGB(pixel.red, pixel.green, pixel.blue));
-    }
+  for (i = 0; i < ANIMAX_MAX_LAYERS; i++) {
+    Row.phase[i] = (Planes && Planes->phase[i]) ? Planes->phase[i] + 2 * PixNum : 0;
+    Row.shape[i] = (Planes && Planes->shape[i]) ? Planes->shape[i] + PixNum : 0;
+  }
+  for (i = 0; i < 3; i++) {
+    Row.mask[i] = (Planes && Planes->mask[i]) ? Planes->mask[i] + PixNum : 0;
   }
 }
 
-void ANIMAX_Spiralus2(AniParms *Ap)
+// Bakes the per sample values of the animation that don't change
+// between frames into the arena, for the grid of this frame: cos and
+// sin of the angle of the ROW layers with a constant twist and no
+// angle feed, less the rotation, then the distance shapes, then the
+// masks of the colormap channels. Layers and channels that come out
+// the same share a plane. The planes that don't fit are left to the
+// sample loops, as are all of them once the arena has moved on
+
+void AnimaxWarmup(AnimaxCtx &Ctx, const AnimaxDesc &Desc)
 {
-  timings.master_speed = 0.0011;    // speed ratios for the oscillators
-  timings.ratio[0] = 1.5;         // higher values = faster transitions
-  timings.ratio[1] = 2.3;
-  timings.ratio[2] = 3;
-  timings.ratio[3] = 0.05;
-  timings.ratio[4] = 0.2;
-  timings.ratio[5] = 0.03;
-  timings.ratio[6] = 0.025;
-  timings.ratio[7] = 0.021;
-  timings.ratio[8] = 0.027;
-  timings.offset[0] = 0;
-  timings.offset[1] = 100;
-  timings.offset[2] = 200;
-  timings.offset[3] = 300;
-  timings.offset[4] = 400;
-  timings.offset[5] = 500;
-  timings.offset[6] = 600;
-  
-  AnimaxCalculateOscillators(timings);     // get linear movers and oscillators going
-
-  for (int x = 0; x < LEDI_WIDTH; x++) {
-    for (int y = 0; y < LEDI_HEIGHT; y++) {
-      
-      animation.dist       = distance[pXY(x, y)] ;
-      animation.angle      = 2*polar_theta[pXY(x, y)] + move.noise_angle[5] + move.directional[3] * move.noise_angle[6]* animation.dist/10;
-      animation.scale_x    = 0.08;
-      animation.scale_y    = 0.08;
-      animation.scale_z    = 0.02;
-      animation.offset_y   = -move.linear[0];
-      animation.offset_x   = 0;
-      animation.offset_z   = 0;
-      animation.z          = move.linear[1];
-      float show1          = AnimaxRenderValue(animation);
-
-      animation.angle      = 3*polar_theta[pXY(x, y)] + move.noise_angle[7] + move.directional[5] * move.noise_angle[8]* animation.dist/10;
-      animation.offset_y   = -move.linear[1];
-      animation.z          = move.linear[2];
-            
-      float show2          = AnimaxRenderValue(animation);
-
-      animation.angle      = 4*polar_theta[pXY(x, y)] + move.noise_angle[6] + move.directional[6] * move.noise_angle[7]* animation.dist/10;
-      animation.offset_y   = move.linear[2];
-      animation.z          = move.linear[0];
-      animation.dist       = distance[pXY(x, y)] *0.8;
-      float show3          = AnimaxRenderValue(animation);
-      
-      
-      float f =  (20-distance[pXY(x, y)])/20;
-     
-      pixel.red   = f*(show1+show2);
-      pixel.green = f*(show1-show2);
-      pixel.blue  = f*(show3-show1);
-      
-      pixel = AnimaxRgbSanityCheck(pixel);
-      ANI_WritePixel(Ap, pXY(x, y), CRGB(pixel.red, pixel.green, pixel.blue));
+  enum { PHASE, SHAPE, MASK };
+  struct {
+    uint8_t kind;
+    uint8_t a;                      // angle mult, distance shape or masks
+    float b;                        // twist
+  } keys[2 * ANIMAX_MAX_LAYERS + 3];
+  const AnimaxGrid &grid = *Ctx.grid;
+  const AnimaxColormap &cm = Desc.colormap;
+  const AnimaxChannel *channels[] = {&cm.red, &cm.green, &cm.blue};
+  uint32_t bytes = (uint32_t)grid.width * grid.height * 4;    // every plane is 4 bytes a sample
+  int8_t phaseOf[ANIMAX_MAX_LAYERS], shapeOf[ANIMAX_MAX_LAYERS], maskOf[3];
+  uint8_t numPlanes = 0, l, c;
+  uint8_t *base;
+  AnimaxRow row;
+
+  auto plan = [&](uint8_t Kind, uint8_t A, float B) -> int8_t {
+    for (uint8_t p = 0; p < numPlanes; p++) {
+      if (keys[p].kind == Kind && keys[p].a == A && keys[p].b == B) {
+        return p;
+      }
+    }
+    if (animaxArena.base == 0 || (numPlanes + 1) * bytes > ANIMAX_ARENA_SIZE) {
+      return -1;
+    }
+    keys[numPlanes] = {Kind, A, B};
+    return numPlanes++;
+  };
+
+  memset(&Ctx.planes, 0, sizeof(Ctx.planes));
+  Ctx.planes.desc = &Desc;
+  Ctx.planes.grid = &grid;
+
+  for (l = 0; l < Desc.numLayers; l++) {
+    const AnimaxLayer &layer = Desc.layers[l];
+
+    phaseOf[l] = -1;
+    if (layer.twist.k == 0 && layer.twist.base != 0 && layer.feed[ANIMAX_FEED_ANGLE].layer < 0) {
+      phaseOf[l] = plan(PHASE, layer.angleMult, layer.twist.base);
     }
   }
-}
+  for (l = 0; l < Desc.numLayers; l++) {
+    shapeOf[l] = -1;
+    if (Desc.layers[l].distShape != ANIMAX_DIST_LINEAR) {
+      shapeOf[l] = plan(SHAPE, Desc.layers[l].distShape, 0);
+    }
+  }
+  for (c = 0; c < 3; c++) {
+    maskOf[c] = channels[c]->masks ? plan(MASK, channels[c]->masks, 0) : -1;
+  }
+  if (numPlanes == 0) {
+    return;
+  }
 
-void Animax_HotBlob(AniParms *Ap)
-{ // nice one
-  c = micros(); // for time measurement in AnimaxReportPerformance()
-  EVERY_N_MILLIS(500) AnimaxReportPerformance();   // check serial monitor for report
-  a = micros();                   
-
-  AnimaxRunDefaultOscillators();
-
-  for (int x = 0; x < LEDI_WIDTH; x++) {
-    for (int y = 0; y < LEDI_HEIGHT; y++) {
-      
-      animation.dist       = distance[pXY(x, y)] ;
-      animation.angle      = polar_theta[pXY(x, y)];
-      
-      animation.scale_x    = 0.07 + move.directional[0]*0.002;
-      animation.scale_y    = 0.07;
-      
-      animation.offset_y   = -move.linear[0];
-      animation.offset_x   = 0;
-      animation.offset_z   = 0;
-      
-      animation.z          = 0;
-      animation.low_limit  = -1;
-      float show1          = AnimaxRenderValue(animation);
-
-      animation.offset_y   = -move.linear[1];
-      float show3          = AnimaxRenderValue(animation);
-
-      animation.offset_x   = show3/20;
-      animation.offset_y   = -move.linear[0]/2 + show1/70;
-      animation.low_limit  = 0;
-      float show2          = AnimaxRenderValue(animation);
-
-      animation.offset_x   = show3/20;
-      animation.offset_y   = -move.linear[0]/2 + show1/70;
-      animation.z          = 100;
-      float show4          = AnimaxRenderValue(animation);
-
-      float radius = 11;   // radius of a radial brightness filter
-      float radial = (radius-animation.dist)/animation.dist;
-
-      float linear = (y+1)/(LEDI_HEIGHT-1.f);
-      
-      pixel.red   = radial  * show2;
-      pixel.green   = linear * radial* 0.3* (show2-show4);
-      
-      
-      pixel = AnimaxRgbSanityCheck(pixel);
-      ANI_WritePixel(Ap, pXY(x, y), CRGB(pixel.red, pixel.green, pixel.blue));
+  if (animaxArena.used + numPlanes * bytes > ANIMAX_ARENA_SIZE) {
+    animaxArena.used = 0;
+    animaxArena.epoch++;
+  }
+  base = animaxArena.base + animaxArena.used;
+  animaxArena.used += numPlanes * bytes;
+  Ctx.planes.epoch = animaxArena.epoch;
+
+  for (uint16_t gy = 0; gy < grid.height; gy++) {
+    float rowVal = cm.rowDiv ? ((gy << grid.shift) + cm.rowBias) / cm.rowDiv : 1;
+
+    AnimaxDecodeRow(grid, 0, gy, grid.width, row);
+
+    for (uint8_t p = 0; p < numPlanes; p++) {
+      uint8_t *plane = base + p * bytes + (uint32_t)gy * grid.width * 4;
+      int16_t *phase = (int16_t*)plane;
+      float *out = (float*)plane;
+
+      for (uint16_t x = 0; x < grid.width; x++) {
+        float d = row.dist[x];
+        float m = 1;
+
+        switch (keys[p].kind) {
+          case PHASE:
+            m = keys[p].a * row.theta[x] + keys[p].b * d;
+            phase[2 * x]     = (int16_t)lrintf(cosf(m) * 32767);
+            phase[2 * x + 1] = (int16_t)lrintf(sinf(m) * 32767);
+            break;
+          case SHAPE:
+            out[x] = (keys[p].a == ANIMAX_DIST_SQUARE) ? d * d : sqrtf(d);
+            break;
+          default:
+            if (keys[p].a & ANIMAX_MASK_FADE) m *= (cm.radius - d) / cm.radius;
+            if (keys[p].a & ANIMAX_MASK_BLOB) m *= (cm.radius - d) / d;
+            if (keys[p].a & ANIMAX_MASK_ROW)  m *= rowVal;
+            if (keys[p].a & ANIMAX_MASK_DIST) m *= d;
+            out[x] = m;
+            break;
+        }
+      }
     }
   }
-  b = micros(); // for time measurement in report_performance()
+
+  for (l = 0; l < Desc.numLayers; l++) {
+    Ctx.planes.phase[l] = (phaseOf[l] < 0) ? 0 : (const int16_t*)(base + phaseOf[l] * bytes);
+    Ctx.planes.shape[l] = (shapeOf[l] < 0) ? 0 : (const float*)(base + shapeOf[l] * bytes);
+  }
+  for (c = 0; c < 3; c++) {
+    Ctx.planes.mask[c] = (maskOf[c] < 0) ? 0 : (const float*)(base + maskOf[c] * bytes);
+  }
 }
 
+// Frees the buffers the animation allocated while it played. Only the
+// active animations hold any, the next frame allocates them again
+
+void AnimaxCooldown(AnimaxCtx &Ctx)
+{
+  free(Ctx.keys);
+  Ctx.keys = 0;
+  Ctx.keySize = 0;
+  Ctx.keyDesc = 0;
+  free(Ctx.polar);
+  Ctx.polar = 0;
+  free(Ctx.lowRes);
+  free(Ctx.visible);
+  Ctx.lowRes = 0;
+  Ctx.visible = 0;
+  free(Ctx.held);
+  Ctx.held = 0;
+}
 
+// Evaluates the binds of every layer for this frame and folds the
+// constant parts together so the sample loops only do per sample work
 
-void ANIMAX_Zoom(AniParms *Ap)
-{ // nice one
-
-  AnimaxRunDefaultOscillators();
-  timings.master_speed = 0.003;
-  AnimaxCalculateOscillators(timings); 
-
-  for (int x = 0; x < LEDI_WIDTH; x++) {
-    for (int y = 0; y < LEDI_HEIGHT; y++) {
-      
-      animation.dist       = distance[pXY(x, y)] * distance[pXY(x, y)];
-      animation.angle      = polar_theta[pXY(x, y)];
-      
-      animation.scale_x    = 0.01;
-      animation.scale_y    = 0.01;
-      
-      animation.offset_y   = -10*move.linear[0];
-      animation.offset_x   = 0;
-      animation.offset_z   = 0;
-      
-      animation.z          = 0;
-      animation.low_limit  = 0;
-      float show1          = AnimaxRenderValue(animation);
-
-      float linear = (y+1)/(LEDI_HEIGHT-1.f);
-      
-      pixel.red   = show1*linear;
-      pixel.green   = 0;
-      
-      
-      pixel = AnimaxRgbSanityCheck(pixel);
-      ANI_WritePixel(Ap, pXY(x, y), CRGB(pixel.red, pixel.green, pixel.blue));
+void AnimaxBindLayers(AnimaxCtx &Ctx, const AnimaxDesc &Desc)
+{
+  for (uint8_t l = 0; l < Desc.numLayers; l++) {
+    const AnimaxLayer &desc = Desc.layers[l];
+    AnimaxFrameLayer &layer = Ctx.layers[l];
+    float scaleZ = AnimaxBindValue(Ctx.move, desc.scaleZ);
+
+    layer.angleMult = desc.angleMult;
+    layer.distShape = desc.distShape;
+    layer.dist      = AnimaxBindValue(Ctx.move, desc.dist);
+    layer.angle     = AnimaxBindValue(Ctx.move, desc.angle) + AnimaxBindValue(Ctx.move, desc.spin);
+    layer.twist     = AnimaxBindValue(Ctx.move, desc.twist);
+    layer.rotCos    = cosf(layer.angle);
+    layer.rotSin    = sinf(layer.angle);
+    layer.scaleX    = AnimaxBindValue(Ctx.move, desc.scaleX);
+    layer.scaleY    = AnimaxBindValue(Ctx.move, desc.scaleY);
+    layer.baseX     = AnimaxBindValue(Ctx.move, desc.offsetX) + ANIMAX_CENTER_X;
+    layer.baseY     = AnimaxBindValue(Ctx.move, desc.offsetY) + ANIMAX_CENTER_Y;
+    layer.baseZ     = (AnimaxBindValue(Ctx.move, desc.offsetZ) +
+                       AnimaxBindValue(Ctx.move, desc.z)) * scaleZ;
+    layer.zStep     = desc.zDist * scaleZ;
+    layer.lowLimit  = desc.lowLimit;
+    layer.lowScale  = 255 / (1 - desc.lowLimit);
+    layer.noise     = desc.noise;
+    layer.index     = l;
+    memcpy(layer.feed, desc.feed, sizeof(layer.feed));
+
+    // the mode follows the description, not this frame's values, so a layer
+    // doesn't hop between specializations
+    if (desc.twist.base != 0 || desc.twist.k != 0 ||
+        desc.feed[ANIMAX_FEED_ANGLE].layer >= 0) {
+      layer.mode = ANIMAX_MODE_ROW;
+    } else if (desc.angleMult) {
+      layer.mode = ANIMAX_MODE_PLANES;
+    } else {
+      layer.mode = ANIMAX_MODE_CONST;
     }
   }
 }
 
-void ANIMAX_Rings(AniParms *Ap)
+float AnimaxBindValue(const Modulators &Move, const AnimaxBind &Bind)
 {
+  return Bind.base + Bind.k * AnimaxModValue(Move, Bind.a) * AnimaxModValue(Move, Bind.b);
+}
 
-  timings.master_speed = 0.01;    // speed ratios for the oscillators
-  timings.ratio[0] = 1;         // higher values = faster transitions
-  timings.ratio[1] = 1.1;
-  timings.ratio[2] = 1.2;
-  
-  timings.offset[1] = 100;
-  timings.offset[2] = 200;
-  timings.offset[3] = 300;
-  
-  AnimaxCalculateOscillators(timings);     // get linear movers and oscillators going
-
-  for (int x = 0; x < LEDI_WIDTH; x++) {
-    for (int y = 0; y < LEDI_HEIGHT; y++) {
-  
-      // describe and render animation layers
-      animation.angle      = 5;
-      animation.scale_x    = 0.2;
-      animation.scale_y    = 0.2;
-      animation.scale_z    = 1;
-      animation.dist       = distance[pXY(x,y)];
-      animation.offset_y   = -move.linear[0];
-      animation.offset_x   = 0;
-      float show1          = AnimaxRenderValue(animation);
-
-       // describe and render animation layers
-      animation.angle      = 10;
-      
-      animation.dist       = distance[pXY(x,y)];
-      animation.offset_y   = -move.linear[1];
-      float show2          = AnimaxRenderValue(animation);
-
-       // describe and render animation layers
-      animation.angle      = 12;
-      
-      animation.dist       = distance[pXY(x,y)];
-      animation.offset_y   = -move.linear[2];
-      float show3          = AnimaxRenderValue(animation);
-
-      // colormapping
-      pixel.red   = show1;
-      pixel.green = show2 / 4;
-      pixel.blue  = show3 / 4;
-
-      pixel = AnimaxRgbSanityCheck(pixel);
-
-      ANI_WritePixel(Ap, pXY(x, y), CRGB(pixel.red, pixel.green, pixel.blue));
-    }
+float AnimaxModValue(const Modulators &Move, AnimaxMod Mod)
+{
+  uint8_t n = Mod & 0x0F;
+
+  switch (Mod & 0xF0) {
+    case ANIMAX_LIN(0):
+      return Move.linear[n];
+    case ANIMAX_RAD(0):
+      return Move.radial[n];
+    case ANIMAX_DIR(0):
+      return Move.directional[n];
+    case ANIMAX_NOISE(0):
+      return Move.noise_angle[n];
+    default:
+      return 1;
   }
 }
 
-void ANIMAX_Waves(AniParms *Ap)
+// Picks the specialization of AnimaxRenderLayerT() for the layer
+
+void AnimaxRenderLayer(AnimaxCtx &Ctx, const AnimaxFrameLayer &Layer, const AnimaxRow &Row,
+                       float (*Show)[LEDI_WIDTH], float *Out, uint16_t First, uint16_t Count)
 {
+  bool feedXY = Layer.feed[ANIMAX_FEED_X].layer >= 0 || Layer.feed[ANIMAX_FEED_Y].layer >= 0;
 
-a = micros();                   // for time measurement in AnimaxReportPerformance()
-
-  timings.master_speed = 0.01;    // speed ratios for the oscillators
-  timings.ratio[0] = 2;         // higher values = faster transitions
-  timings.ratio[1] = 2.1;
-  timings.ratio[2] = 1.2;
-  
-  timings.offset[1] = 100;
-  timings.offset[2] = 200;
-  timings.offset[3] = 300;
-  
-  AnimaxCalculateOscillators(timings);     // get linear movers and oscillators going
-
-  for (int x = 0; x < LEDI_WIDTH; x++) {
-    for (int y = 0; y < LEDI_HEIGHT; y++) {
-  
-      // describe and render animation layers
-      animation.angle      = polar_theta[pXY(x,y)];
-      animation.scale_x    = 0.1;
-      animation.scale_y    = 0.1;
-      animation.scale_z    = 0.1;
-      animation.dist       = distance[pXY(x,y)];
-      animation.offset_y   = 0;
-      animation.offset_x   = 0;
-      animation.z          = 2*distance[pXY(x,y)] - move.linear[0];
-      float show1          = AnimaxRenderValue(animation);
-
-      animation.angle      = polar_theta[pXY(x,y)];
-      animation.dist       = distance[pXY(x,y)];
-      animation.z          = 2*distance[pXY(x,y)] - move.linear[1];
-      float show2          = AnimaxRenderValue(animation);
-
-  
-      // colormapping
-      pixel.red   = show1;
-      pixel.green = 0;
-      pixel.blue  = show2;
-
-      pixel = AnimaxRgbSanityCheck(pixel);
-
-      ANI_WritePixel(Ap, pXY(x, y), CRGB(pixel.red, pixel.green, pixel.blue));
-    }
+  uint8_t mode = Layer.mode;
+
+  // the rows of the polar grid and of stale planes have no phase plane
+  if (mode == ANIMAX_MODE_ROW && Row.phase[Layer.index] != 0) {
+    mode = ANIMAX_MODE_BAKED;
+  }
+
+  switch (mode) {
+    case ANIMAX_MODE_BAKED:
+      if (feedXY) {
+        AnimaxRenderLayerT<ANIMAX_MODE_BAKED, true>(Ctx, Layer, Row, Show, Out, First, Count);
+      } else {
+        AnimaxRenderLayerT<ANIMAX_MODE_BAKED, false>(Ctx, Layer, Row, Show, Out, First, Count);
+      }
+      break;
+    case ANIMAX_MODE_ROW:
+      if (feedXY) {
+        AnimaxRenderLayerT<ANIMAX_MODE_ROW, true>(Ctx, Layer, Row, Show, Out, First, Count);
+      } else {
+        AnimaxRenderLayerT<ANIMAX_MODE_ROW, false>(Ctx, Layer, Row, Show, Out, First, Count);
+      }
+      break;
+    case ANIMAX_MODE_CONST:
+      if (feedXY) {
+        AnimaxRenderLayerT<ANIMAX_MODE_CONST, true>(Ctx, Layer, Row, Show, Out, First, Count);
+      } else {
+        AnimaxRenderLayerT<ANIMAX_MODE_CONST, false>(Ctx, Layer, Row, Show, Out, First, Count);
+      }
+      break;
+    default:
+      if (feedXY) {
+        AnimaxRenderLayerT<ANIMAX_MODE_PLANES, true>(Ctx, Layer, Row, Show, Out, First, Count);
+      } else {
+        AnimaxRenderLayerT<ANIMAX_MODE_PLANES, false>(Ctx, Layer, Row, Show, Out, First, Count);
+      }
+      break;
   }
 }
 
-void ANIMAX_CenterField(AniParms *Ap)
+// Convert the 2 polar coordinates back to cartesian ones & also apply all 3d transitions.
+// Calculate the noise value at these points based on the 5 dimensional manipulation of
+// the underlaying coordinates. The Count samples from First on are rendered in one go so
+// the noise kernel can work on a whole batch at once.
+// Angles of the form k * polar_theta + rotation don't need any trig per sample. cos(k*theta)
+// and sin(k*theta) follow from the cos_theta/sin_theta planes by the multiple angle identities
+// and the rotation is applied with the angle addition identities. Only layers with a per
+// sample angle term still go through cosf() and sinf().
+
+template <uint8_t AngleMode, bool FeedXY>
+void AnimaxRenderLayerT(AnimaxCtx &Ctx, const AnimaxFrameLayer &Layer, const AnimaxRow &Row,
+                        float (*Show)[LEDI_WIDTH], float *Out, uint16_t First,
+                        uint16_t Count)
 {
+  float newx[ANIMAX_RENDER_CHUNK];
+  float newy[ANIMAX_RENDER_CHUNK];
+  float newz[ANIMAX_RENDER_CHUNK];
+  float dist[ANIMAX_RENDER_CHUNK];
+  float raw[ANIMAX_RENDER_CHUNK];
+  const AnimaxFeed *feed = Layer.feed;
+  uint16_t end = First + Count;
+  uint16_t base, i, n;
+
+  for (base = First; base < end; base += n) {
+    const float *d = Row.dist + base;
+
+    n = end - base;
+    if (n > ANIMAX_RENDER_CHUNK) {
+      n = ANIMAX_RENDER_CHUNK;
+    }
 
-  timings.master_speed = 0.01;    // speed ratios for the oscillators
-  timings.ratio[0] = 1;         // higher values = faster transitions
-  timings.ratio[1] = 1.1;
-  timings.ratio[2] = 1.2;
-  
-  timings.offset[1] = 100;
-  timings.offset[2] = 200;
-  timings.offset[3] = 300;
-  
-  AnimaxCalculateOscillators(timings);     // get linear movers and oscillators going
-
-  for (int x = 0; x < LEDI_WIDTH; x++) {
-    for (int y = 0; y < LEDI_HEIGHT; y++) {
-  
-      // describe and render animation layers
-      animation.angle      = polar_theta[pXY(x,y)];
-      animation.scale_x    = 0.07;
-      animation.scale_y    = 0.07;
-      animation.scale_z    = 0.1;
-      animation.dist       = 5*sqrtf(distance[pXY(x,y)]);
-      animation.offset_y   = move.linear[0];
-      animation.offset_x   = 0;
-      animation.z          = 0;
-      float show1          = AnimaxRenderValue(animation);
-
-      animation.angle      = polar_theta[pXY(x,y)];
-      animation.scale_x    = 0.07;
-      animation.scale_y    = 0.07;
-      animation.scale_z    = 0.1;
-      animation.dist       = 4*sqrtf(distance[pXY(x,y)]);
-      animation.offset_y   = move.linear[0];
-      animation.offset_x   = 0;
-      animation.z          = 0;
-      float show2          = AnimaxRenderValue(animation);
-
-     
-
-  
-      // colormapping
-      pixel.red   = show1;
-      pixel.green = show2;
-      pixel.blue  = 0;
-
-      pixel = AnimaxRgbSanityCheck(pixel);
-
-      ANI_WritePixel(Ap, pXY(x, y), CRGB(pixel.red, pixel.green, pixel.blue));
+    // distance the layer is rendered at
+
+    if (Row.shape[Layer.index] != 0) {
+      const float *shape = Row.shape[Layer.index] + base;
+
+      for (i = 0; i < n; i++) {
+        dist[i] = Layer.dist * shape[i];
+      }
+    } else switch (Layer.distShape) {
+      case ANIMAX_DIST_SQUARE:
+        for (i = 0; i < n; i++) {
+          dist[i] = Layer.dist * (d[i] * d[i]);
+        }
+        break;
+      case ANIMAX_DIST_SQRT:
+        for (i = 0; i < n; i++) {
+          dist[i] = Layer.dist * sqrtf(d[i]);
+        }
+        break;
+      default:
+        for (i = 0; i < n; i++) {
+          dist[i] = Layer.dist * d[i];
+        }
+        break;
+    }
+    if (feed[ANIMAX_FEED_DIST].layer >= 0) {
+      AnimaxAddFeed(dist, feed[ANIMAX_FEED_DIST], Show, base, n);
     }
-  }
 
-}
+    // offsets fed by earlier layers
 
+    if (FeedXY) {
+      for (i = 0; i < n; i++) {
+        newx[i] = Layer.baseX;
+        newy[i] = Layer.baseY;
+      }
+      if (feed[ANIMAX_FEED_X].layer >= 0) {
+        AnimaxAddFeed(newx, feed[ANIMAX_FEED_X], Show, base, n);
+      }
+      if (feed[ANIMAX_FEED_Y].layer >= 0) {
+        AnimaxAddFeed(newy, feed[ANIMAX_FEED_Y], Show, base, n);
+      }
+    }
 
+    // per sample angles
 
-/* --------------------------------------------------------------------------------------------
- *  PRIVATE FUNCTIONS
- * --------------------------------------------------------------------------------------------
- */
+    if (AngleMode == ANIMAX_MODE_ROW) {
+      const float *theta = Row.theta + base;
 
+      for (i = 0; i < n; i++) {
+        raw[i] = Layer.angleMult * theta[i] + Layer.angle + Layer.twist * d[i];
+      }
+      if (feed[ANIMAX_FEED_ANGLE].layer >= 0) {
+        AnimaxAddFeed(raw, feed[ANIMAX_FEED_ANGLE], Show, base, n);
+      }
+    }
 
-void AnimaxCalculateOscillators(Oscillators &Timings)
-{
+    // convert polar coordinates back to cartesian ones
+
+    for (i = 0; i < n; i++) {
+      float offx = FeedXY ? newx[i] : Layer.baseX;
+      float offy = FeedXY ? newy[i] : Layer.baseY;
+      float cosA, sinA;
+
+      if (AngleMode == ANIMAX_MODE_ROW) {
+        cosA = cosf(raw[i]);
+        sinA = sinf(raw[i]);
+      } else if (AngleMode == ANIMAX_MODE_BAKED) {
+        const int16_t *phase = Row.phase[Layer.index] + 2 * (base + i);
+        float cosP = phase[0] * (1.f / 32767);
+        float sinP = phase[1] * (1.f / 32767);
+
+        cosA = cosP * Layer.rotCos - sinP * Layer.rotSin;
+        sinA = sinP * Layer.rotCos + cosP * Layer.rotSin;
+      } else if (AngleMode == ANIMAX_MODE_PLANES) {
+        float cosK = Row.cosTheta[base + i];
+        float sinK = Row.sinTheta[base + i];
+
+        AnimaxAngleMultiple(cosK, sinK, Layer.angleMult);
+        cosA = cosK * Layer.rotCos - sinK * Layer.rotSin;
+        sinA = sinK * Layer.rotCos + cosK * Layer.rotSin;
+      } else {
+        cosA = Layer.rotCos;
+        sinA = Layer.rotSin;
+      }
 
-  double runtime = millis() * Timings.master_speed;  // global anaimation speed
+      newx[i] = (offx - (cosA * dist[i])) * Layer.scaleX;
+      newy[i] = (offy - (sinA * dist[i])) * Layer.scaleY;
+      newz[i] = Layer.baseZ + Layer.zStep * d[i];
+    }
 
-  for (int i = 0; i < NUM_OSCILLATORS; i++) {
-    
-    move.linear[i]      = (runtime + Timings.offset[i]) * Timings.ratio[i];     // continously rising offsets, returns              0 to max_float
-    
-    move.radial[i]      = fmodf(move.linear[i], 2 * PI);                        // angle offsets for continous rotation, returns    0 to 2 * PI
-    
-    move.directional[i] = sinf(move.radial[i]);                                 // directional offsets or factors, returns         -1 to 1
-    
-    move.noise_angle[i] = PI * (1 + AnimaxPnoise(move.linear[i], 0, 0));              // noise based angle offset, returns                0 to 2 * PI
-    
+    // render noisevalues at the new cartesian points
+
+    if (Layer.noise != ANIMAX_PERLIN) {
+      ANOISE_FbmBatch(newx, newy, newz, raw, n, ANIMAX_NOISE_OCTAVES(Layer.noise), 0.5f,
+                      ANIMAX_NOISE_TURB(Layer.noise));
+    } else {
+      switch (Ctx.noiseSrc) {
+        case ANOISE_SRC_FIXED:
+          AnimaxNoiseRowQ16(newx, newy, newz, raw, n);
+          break;
+        case ANOISE_SRC_VOLUME:
+          ANOISE_VolumeBatch(newx, newy, newz, raw, n);
+          break;
+        case ANOISE_SRC_SIMPLEX:
+          ANOISE_SnoiseBatch(newx, newy, newz, raw, n);
+          break;
+        default:
+          ANOISE_PnoiseBatch(newx, newy, newz, raw, n);
+          break;
+      }
+    }
+
+    // A) enhance histogram (improve contrast) by setting the black point (lowLimit)
+    // B) scale the result to a 0-255 range (assuming you want 8 bit color depth per rgb chanel)
+    // Here happens the contrast boosting & the brightness mapping
+
+    for (i = 0; i < n; i++) {
+      float v = raw[i];
+
+      v = (v > Layer.lowLimit) ? v : Layer.lowLimit;
+      v = (v < 1) ? v : 1;
+
+      Out[base + i] = (v - Layer.lowLimit) * Layer.lowScale;
+    }
   }
 }
 
-// Convert the 2 polar coordinates back to cartesian ones & also apply all 3d transitions.
-// Calculate the noise value at this point based on the 5 dimensional manipulation of 
-// the underlaying coordinates.
+// Adds Feed.k times the output of an earlier layer to Count per sample values
 
-float AnimaxRenderValue(RenderParameters &Animation)
+void AnimaxAddFeed(float *Dst, const AnimaxFeed &Feed, float (*Show)[LEDI_WIDTH],
+                   uint16_t Base, uint16_t Count)
 {
+  const float *src = &Show[Feed.layer][Base];
 
-  // convert polar coordinates back to cartesian ones
+  for (uint16_t i = 0; i < Count; i++) {
+    Dst[i] += Feed.k * src[i];
+  }
+}
 
-  float newx = (animation.offset_x + animation.center_x - (cosf(animation.angle) * animation.dist)) * animation.scale_x;
-  float newy = (animation.offset_y + animation.center_y - (sinf(animation.angle) * animation.dist)) * animation.scale_y;
-  float newz = (animation.offset_z + animation.z) * animation.scale_z;
+// Colormapping of one span, fused with the clamp and the pack. Each
+// channel is worked out a stretch of writable samples at a time in
+// flat loops over float rows, the per sample divides are baked into
+// the mask planes or replaced by reciprocals, and the three rows are
+// saturated to 8 bit into a packed row in one pass. A reduced quality
+// frame packs straight into its grid buffer. Only the samples from
+// First to Last are within the support radius, the rest are black.
+// The ones that aren't writable are left alone
+
+void AnimaxColormapRow(AnimaxCtx &Ctx, AniParms *Ap, const AnimaxDesc &Desc,
+                       float (*Show)[LEDI_WIDTH], const AnimaxRow &Row, const uint8_t *Writable,
+                       uint16_t Y, uint32_t PixNum, uint16_t First, uint16_t Last,
+                       uint16_t Count)
+{
+  const AnimaxColormap &cm = Desc.colormap;
+  const AnimaxChannel *channels[] = {&cm.red, &cm.green, &cm.blue};
+  float rgb[3][LEDI_WIDTH];
+  CRGB packed[LEDI_WIDTH];
+  CRGB *out = (Ctx.grid->shift == ANIMAX_QUALITY_FULL) ? packed : &Ctx.lowRes[PixNum];
+  float row = cm.rowDiv ? (Y + cm.rowBias) / cm.rowDiv : 1;
+  uint16_t x, i, end;
+
+  for (x = 0; x < Count; x++) {
+    out[x] = CRGB::Black;
+  }
 
-  // render noisevalue at this new cartesian point
+  for (i = First; i < Last; i = end) {
+    while (i < Last && !Writable[i]) {
+      i++;
+    }
+    for (end = i; end < Last && Writable[end]; end++) {
+    }
+    for (uint8_t c = 0; c < 3; c++) {
+      AnimaxChannelRow(*channels[c], cm, Desc.numLayers, Show, Row, row, Row.mask[c], rgb[c],
+                       i, end - i);
+    }
+    for (x = i; x < end; x++) {
+      out[x].r = AnimaxSat8(rgb[0][x]);
+      out[x].g = AnimaxSat8(rgb[1][x]);
+      out[x].b = AnimaxSat8(rgb[2][x]);
+    }
+  }
 
-  float raw_noise_field_value = AnimaxPnoise(newx, newy, newz);
-  
-  // A) enhance histogram (improve contrast) by setting the black and white point (low & high_limit)
-  // B) scale the result to a 0-255 range (assuming you want 8 bit color depth per rgb chanel)
-  // Here happens the contrast boosting & the brightness mapping
+  // Pixels that aren't writable are refused again by ANI_WriteSpan()
+  if (out == packed) {
+    ANI_WriteSpan(Ap, PixNum, packed, Count);
+  }
+}
 
-  if (raw_noise_field_value < animation.low_limit)  raw_noise_field_value =  animation.low_limit;
-  if (raw_noise_field_value > animation.high_limit) raw_noise_field_value = animation.high_limit;
+// One colormap channel of the Count samples from First on. The product
+// term and the weighted sum of the layers, times the masks of the
+// channel. Layers the channel doesn't use are skipped
 
-  float scaled_noise_value = AnimaxMapFloat(raw_noise_field_value, animation.low_limit, animation.high_limit, 0, 255);
+void AnimaxChannelRow(const AnimaxChannel &Ch, const AnimaxColormap &Cm, uint8_t NumLayers,
+                      float (*Show)[LEDI_WIDTH], const AnimaxRow &Row, float RowMask,
+                      const float *Mask, float *Out, uint16_t First, uint16_t Count)
+{
+  uint16_t end = First + Count;
+  const float *d = Row.dist;
+  uint16_t x;
 
-  return scaled_noise_value;
-}
+  if (Ch.prodK != 0) {
+    const float *a = Show[Ch.prodA], *b = Show[Ch.prodB];
 
+    for (x = First; x < end; x++) {
+      Out[x] = Ch.prodK * a[x] * b[x];
+    }
+  } else {
+    memset(&Out[First], 0, Count * sizeof(float));
+  }
+  for (uint8_t l = 0; l < NumLayers; l++) {
+    const float *src = Show[l];
+    float k = Ch.k[l];
 
+    if (k == 0) {
+      continue;
+    }
+    for (x = First; x < end; x++) {
+      Out[x] += k * src[x];
+    }
+  }
 
-// given a static polar origin we can precalculate 
-// the polar coordinates
+  if (Mask != 0) {
+    for (x = First; x < end; x++) {
+      Out[x] *= Mask[x];
+    }
+    return;
+  }
+  if (Ch.masks & ANIMAX_MASK_FADE) {
+    float perRadius = 1 / Cm.radius;
 
-void AnimaxRenderPolarLookupTable(float cx, float cy)
-{
-    int xx, yy;
-  for (xx = 0; xx < LEDI_WIDTH; xx++) {
-    for (yy = 0; yy < LEDI_HEIGHT; yy++) {
+    for (x = First; x < end; x++) {
+      Out[x] *= (Cm.radius - d[x]) * perRadius;
+    }
+  }
+  if (Ch.masks & ANIMAX_MASK_BLOB) {
+    for (x = First; x < end; x++) {
+      Out[x] *= (Cm.radius - d[x]) / d[x];
+    }
+  }
+  if (Ch.masks & ANIMAX_MASK_ROW) {
+    for (x = First; x < end; x++) {
+      Out[x] *= RowMask;
+    }
+  }
+  if (Ch.masks & ANIMAX_MASK_DIST) {
+    for (x = First; x < end; x++) {
+      Out[x] *= d[x];
+    }
+  }
+}
 
-      float dx = xx - cx;
-      float dy = yy - cy;
+// Turns cos(theta), sin(theta) into cos(k*theta), sin(k*theta) with a few multiply-adds
 
-      distance[pXY(xx, yy)]    = hypotf(dx, dy);
-      polar_theta[pXY(xx, yy)] = atan2f(dy, dx); 
-    }
+void AnimaxAngleMultiple(float &CosA, float &SinA, uint8_t K)
+{
+  float c1 = CosA, s1 = SinA;
+  float c2 = c1 * c1 - s1 * s1, s2 = 2 * s1 * c1;
+
+  switch (K) {
+    case 2:
+      CosA = c2;
+      SinA = s2;
+      break;
+    case 3:
+      CosA = c2 * c1 - s2 * s1;
+      SinA = s2 * c1 + c2 * s1;
+      break;
+    case 4:
+      CosA = c2 * c2 - s2 * s2;
+      SinA = 2 * s2 * c2;
+      break;
+    case 5:
+      CosA = c2 * c2 - s2 * s2;
+      SinA = 2 * s2 * c2;
+      c2 = CosA * c1 - SinA * s1;
+      SinA = SinA * c1 + CosA * s1;
+      CosA = c2;
+      break;
+    default:
+      break;
   }
 }
 
-// float mapping maintaining 32 bit precision
-// we keep values with high resolution for potential later usage
+// Same as ANOISE_PnoiseBatch() but rendered by the Q16.16 fixed point engine
+
+void AnimaxNoiseRowQ16(const float *X, const float *Y, const float *Z, float *Out, uint16_t Count)
+{
+  int32_t qx[ANIMAX_RENDER_CHUNK];
+  int32_t qy[ANIMAX_RENDER_CHUNK];
+  int32_t qz[ANIMAX_RENDER_CHUNK];
+  int32_t q[ANIMAX_RENDER_CHUNK];
+  uint16_t i;
+
+  for (i = 0; i < Count; i++) {
+    qx[i] = ANOISE_FloatToQ16(X[i]);
+    qy[i] = ANOISE_FloatToQ16(Y[i]);
+    qz[i] = ANOISE_FloatToQ16(Z[i]);
+  }
 
-float AnimaxMapFloat(float x, float in_min, float in_max, float out_min, float out_max)
-{ 
-  
-  float result = (x-in_min) * (out_max-out_min) / (in_max-in_min) + out_min;
-  if (result < out_min) result = out_min;
-  if( result > out_max) result = out_max;
+  ANOISE_PnoiseBatchQ16(qx, qy, qz, q, Count);
 
-  return result; 
+  for (i = 0; i < Count; i++) {
+    Out[i] = q[i] * (1.f / ANOISE_Q16_ONE);
+  }
 }
 
+#if ANIMAX_DIAGNOSTICS
+// Compares the compile time polar tables with the runtime math
+// they replace and prints the largest differences
+
+void AnimaxCheckPolarTables(void)
+{
+  for (uint8_t q = 0; q < ANIMAX_NUM_QUALITY; q++) {
+    const AnimaxGrid &grid = grids[q];
+    float half = ((1 << q) - 1) * 0.5f;
+    float maxDist = 0, maxTheta = 0, maxCos = 0;
+    AnimaxRow row;
+
+    for (uint16_t yy = 0; yy < grid.height; yy++) {
+      AnimaxDecodeRow(grid, 0, yy, grid.width, row);
+      for (uint16_t xx = 0; xx < grid.width; xx++) {
+        float dx = (xx << q) + half - ANIMAX_CENTER_X;
+        float dy = (yy << q) + half - ANIMAX_CENTER_Y;
+        float theta = atan2f(dy, dx);
+
+        maxDist  = max(maxDist, fabsf(row.dist[xx] - hypotf(dx, dy)));
+        maxTheta = max(maxTheta, fabsf(row.theta[xx] - theta));
+        maxCos   = max(maxCos, fabsf(row.cosTheta[xx] - cosf(theta)));
+        maxCos   = max(maxCos, fabsf(row.sinTheta[xx] - sinf(theta)));
+      }
+    }
+    Serial.printf("Animax polar tables quality %u: max error dist %g theta %g cos/sin %g\n",
+                  q, maxDist, maxTheta, maxCos);
+  }
+}
+#endif /* ANIMAX_DIAGNOSTICS */
 
-// Avoid any possible color flicker by forcing the raw RGB values to be 0-255.
-// This enables to play freely with random equations for the colormapping
-// without causing flicker by accidentally missing the valid target range.
+// Picks the grid for the quality of the AniParms and takes
+// the per animation settings, lowered by the steps of the
+// adaptive quality level: first the resolution, then the
+// noise volume, then the top layers, which AnimaxHoldRow()
+// holds still. Falls back to full quality when the low
+// resolution buffers can't be allocated, and keeps all the
+// layers when the held ones can't
 
-AnimaxRgb AnimaxRgbSanityCheck(AnimaxRgb &Pixel)
+void AnimaxBeginFrame(AnimaxCtx &Ctx, AniParms *Ap, const AnimaxDesc &Desc)
 {
+  AnimaxQuality quality = Ap->p.animax.quality;
+  uint8_t steps = Ctx.level, n;
+
+  Ctx.noiseSrc = Ap->p.animax.noiseSrc;
 
-   
-    // discard everything above the valid 8 bit colordepth 0-255 range
-    if (Pixel.red   > 0xFF)   Pixel.red = 0xFF;
-    if (Pixel.green > 0xFF) Pixel.green = 0xFF;
-    if (Pixel.blue  > 0xFF)  Pixel.blue = 0xFF;
+  if (quality >= ANIMAX_NUM_QUALITY) {
+    quality = ANIMAX_QUALITY_FULL;
+  }
+  n = min(steps, (uint8_t)(ANIMAX_NUM_QUALITY - 1 - quality));
+  quality += n;
+  steps -= n;
+  if (steps > 0 && Ctx.noiseSrc != ANOISE_SRC_VOLUME) {
+    Ctx.noiseSrc = ANOISE_SRC_VOLUME;
+    steps--;
+  }
+  Ctx.numLayers = Desc.numLayers - min(steps, (uint8_t)(Desc.numLayers - 1));
+
+  if (quality != ANIMAX_QUALITY_FULL) {
+    if (Ctx.lowRes == 0) {
+      // sized for the largest reduced grid so the quality can change at any time
+      Ctx.lowRes = (CRGB*)malloc(sizeof(CRGB) *
+                                 ANIMAX_GRID_DIM(LEDI_WIDTH, ANIMAX_QUALITY_HALF) *
+                                 ANIMAX_GRID_DIM(LEDI_HEIGHT, ANIMAX_QUALITY_HALF));
+      Ctx.visible = (uint8_t*)malloc(ANIMAX_GRID_DIM(LEDI_WIDTH, ANIMAX_QUALITY_HALF) *
+                                     ANIMAX_GRID_DIM(LEDI_HEIGHT, ANIMAX_QUALITY_HALF));
+      if (Ctx.lowRes == 0 || Ctx.visible == 0) {
+        Serial.println("Could not allocate memory for animatrix");
+        free(Ctx.lowRes);
+        free(Ctx.visible);
+        Ctx.lowRes = 0;
+        Ctx.visible = 0;
+        quality = ANIMAX_QUALITY_FULL;
+      }
+    }
+  }
+  Ctx.grid = &grids[quality];
+
+  // the next level drops a layer, start keeping what to hold it at
+  if (quality == ANIMAX_QUALITY_QUARTER && Ctx.noiseSrc == ANOISE_SRC_VOLUME &&
+      Desc.numLayers > 1 && Ctx.held == 0) {
+    Ctx.held = (uint16_t*)malloc(sizeof(uint16_t) * (ANIMAX_MAX_LAYERS - 1) *
+                                 ANIMAX_GRID_DIM(LEDI_WIDTH, ANIMAX_QUALITY_QUARTER) *
+                                 ANIMAX_GRID_DIM(LEDI_HEIGHT, ANIMAX_QUALITY_QUARTER));
+    if (Ctx.held == 0) {
+      Serial.println("Could not allocate memory for animatrix");
+    }
+  }
+  if (quality != ANIMAX_QUALITY_QUARTER || Ctx.held == 0) {
+    Ctx.numLayers = Desc.numLayers;
+  }
 
-    return Pixel;
+  if (quality != ANIMAX_QUALITY_FULL) {
+    AnimaxMarkVisible(Ctx);
+  }
 }
 
-float AnimaxPnoise(float x, float y, float z)
+// Number of steps the adaptive quality controller can take from
+// the settings of the AniParms, as AnimaxBeginFrame() applies them
+
+uint8_t AnimaxMaxLevel(AniParms *Ap, const AnimaxDesc &Desc)
 {
-  
-int   X = (int)floorf(x) & 0xFF,             /* FIND UNIT CUBE THAT */
-      Y = (int)floorf(y) & 0xFF,             /* CONTAINS POINT.     */
-      Z = (int)floorf(z) & 0xFF;
-x -= floorf(x);                             /* FIND RELATIVE X,Y,Z */
-y -= floorf(y);                             /* OF POINT IN CUBE.   */
-z -= floorf(z);
-float  u = NOISE_FADE(x),                         /* COMPUTE FADE CURVES */
-       v = NOISE_FADE(y),                         /* FOR EACH OF X,Y,Z.  */
-       w = NOISE_FADE(z);
-int  A = p[X & 0xFF]+Y, 
-     AA = p[(A) & 0xFF]+Z, 
-     AB = p[(A+1) & 0xFF]+Z,                         /* HASH COORDINATES OF */
-     B = p[(X+1) & 0xFF]+Y, 
-     BA = p[(B) & 0xFF]+Z, 
-     BB = p[(B+1) & 0xFF]+Z;                         /* THE 8 CUBE CORNERS, */
-
-return NOISE_LERP(w,NOISE_LERP(v,NOISE_LERP(u, AnimaxNoiseGrad(p[AA & 0xFF], x, y, z),    /* AND ADD */
-                          AnimaxNoiseGrad(p[BA & 0xFF], x-1, y, z)),    /* BLENDED */
-              NOISE_LERP(u, AnimaxNoiseGrad(p[AB & 0xFF], x, y-1, z),         /* RESULTS */
-                   AnimaxNoiseGrad(p[BB & 0xFF], x-1, y-1, z))),        /* FROM  8 */
-            NOISE_LERP(v, NOISE_LERP(u, AnimaxNoiseGrad(p[(AA+1) & 0xFF], x, y, z-1),   /* CORNERS */
-                 AnimaxNoiseGrad(p[(BA+1) & 0xFF], x-1, y, z-1)),           /* OF CUBE */
-              NOISE_LERP(u, AnimaxNoiseGrad(p[(AB+1) & 0xFF], x, y-1, z-1),
-                   AnimaxNoiseGrad(p[(BB+1) & 0xFF], x-1, y-1, z-1))));
+  AnimaxQuality quality = Ap->p.animax.quality;
+
+  if (quality >= ANIMAX_NUM_QUALITY) {
+    quality = ANIMAX_QUALITY_FULL;
+  }
+  return (ANIMAX_NUM_QUALITY - 1 - quality) +
+         (Ap->p.animax.noiseSrc != ANOISE_SRC_VOLUME) + (Desc.numLayers - 1);
 }
 
-float AnimaxNoiseGrad(int hash, float x, float y, float z)
+// Adaptive quality controller. Smooths the render time of the frames
+// and drops the quality a level when it is over the budget. What each
+// step saved is measured once the level has settled, so a step is only
+// taken back when the frame would fit the headroom without it, rather
+// than whenever the cheaper level fits. That keeps the level from
+// bouncing between two steps that straddle the budget
+
+void AnimaxAdapt(AnimaxCtx &Ctx, AniParms *Ap, const AnimaxDesc &Desc, uint32_t RenderUs)
 {
-    int    h = hash & 15;          /* CONVERT LO 4 BITS OF HASH CODE */
-    float  u = h < 8 ? x : y,      /* INTO 12 GRADIENT DIRECTIONS.   */
-          v = h < 4 ? y : h==12||h==14 ? x : z;
-    return ((h&1) == 0 ? u : -u) + ((h&2) == 0 ? v : -v); 
+  uint32_t budget = Ap->p.animax.budgetUs;
+  uint8_t level = Ctx.level;
+
+  // by default the frame is held to the rate the animation is drawn at
+  if (budget == 0) {
+    budget = Ap->fpsTarg ? 1000000 / Ap->fpsTarg : ANIMAX_FRAME_BUDGET_US;
+  }
+
+  if (budget == 0 || budget == ANIMAX_BUDGET_OFF) {
+    Ctx.level = 0;
+    return;
+  }
+
+  // the first frames at a level pay for allocations and cold caches
+  if (Ctx.settle < ANIMAX_ADAPT_WARMUP) {
+    Ctx.renderUs = RenderUs;
+  } else {
+    Ctx.renderUs += ((float)RenderUs - Ctx.renderUs) / ANIMAX_ADAPT_SMOOTHING;
+  }
+  if (Ctx.settle < ANIMAX_ADAPT_SETTLE) {
+    if (++Ctx.settle == ANIMAX_ADAPT_SETTLE && Ctx.upperUs > 0) {
+      Ctx.saved[level] = Ctx.upperUs / Ctx.renderUs;
+      Ctx.upperUs = 0;
+    }
+    return;
+  }
+
+  if (Ctx.renderUs > budget && level < AnimaxMaxLevel(Ap, Desc)) {
+    Ctx.upperUs = Ctx.renderUs;
+    level++;
+  } else if (level > 0 &&
+             Ctx.renderUs * Ctx.saved[level] < budget * (ANIMAX_ADAPT_HEADROOM / 100.f)) {
+    Ctx.upperUs = 0;
+    level--;
+  } else {
+    return;
+  }
+
+#if ANIMAX_DIAGNOSTICS
+  Serial.printf("Animax quality level %u -> %u at %u us per frame, budget %u us\r\n",
+                Ctx.level, level, (unsigned)Ctx.renderUs, (unsigned)budget);
+#endif /* ANIMAX_DIAGNOSTICS */
+  Ctx.level = level;
+  Ctx.settle = 0;
 }
 
-void AnimaxRunDefaultOscillators()
+// Flags the samples of a reduced quality frame the upscale
+// blends into a pixel this animation may write. A pixel
+// blends samples of its own block and the blocks around it,
+// so every block with a writable pixel marks its neighbors
+
+void AnimaxMarkVisible(AnimaxCtx &Ctx)
 {
+  const AnimaxGrid &grid = *Ctx.grid;
+  uint8_t writable[LEDI_WIDTH];
+  uint8_t blocks[LEDI_WIDTH];
+  uint16_t x, y, gx, gy, yEnd, gxEnd, gyEnd;
+
+  memset(Ctx.visible, 0, (uint32_t)grid.width * grid.height);
+
+  for (gy = 0; gy < grid.height; gy++) {
+    memset(blocks, 0, grid.width);
+    yEnd = min((gy + 1) << grid.shift, LEDI_HEIGHT);
+    for (y = gy << grid.shift; y < yEnd; y++) {
+      if (ANI_WritableSpan(pXY(0, y), LEDI_WIDTH, writable) == 0) {
+        continue;
+      }
+      for (x = 0; x < LEDI_WIDTH; x++) {
+        blocks[x >> grid.shift] |= writable[x];
+      }
+    }
 
-  timings.master_speed = 0.005;    // master speed
-
-  timings.ratio[0] = 1;           // speed ratios for the oscillators, higher values = faster transitions
-  timings.ratio[1] = 2;
-  timings.ratio[2] = 3;
-  timings.ratio[3] = 4;
-  timings.ratio[4] = 5;
-  timings.ratio[5] = 6;
-  timings.ratio[6] = 7;
-  timings.ratio[7] = 8;
-  timings.ratio[8] = 9;
-  timings.ratio[9] = 10;
-
-  
-  timings.offset[0] = 000;
-  timings.offset[1] = 100;
-  timings.offset[2] = 200;
-  timings.offset[3] = 300;
-  timings.offset[4] = 400;
-  timings.offset[5] = 500;
-  timings.offset[6] = 600;
-  timings.offset[7] = 700;
-  timings.offset[8] = 800;
-  timings.offset[9] = 900;
-
-  AnimaxCalculateOscillators(timings);  
+    gyEnd = min(gy + 1, grid.height - 1);
+    for (gx = 0; gx < grid.width; gx++) {
+      if (!blocks[gx]) {
+        continue;
+      }
+      gxEnd = min(gx + 1, grid.width - 1);
+      for (y = (gy > 0) ? gy - 1 : 0; y <= gyEnd; y++) {
+        for (x = (gx > 0) ? gx - 1 : 0; x <= gxEnd; x++) {
+          Ctx.visible[(uint32_t)y * grid.width + x] = 1;
+        }
+      }
+    }
+  }
 }
 
-void AnimaxReportPerformance()
+// Bilinear upscale of a reduced quality frame to the full
+// frame in 8 bit fixed point. Sample centers sit in the
+// middle of their blocks, the edges clamp
+
+void AnimaxEndFrame(AnimaxCtx &Ctx, AniParms *Ap)
 {
-  
-  float calc  = b - a;                         // rendering time
-  float push  = c - b;                         // time to initialize led update
-  float total = c - a;                         // time per frame
-  int fps  = 1000000 / total;                // frames per second
-  int kpps = (fps * LEDI_WIDTH * LEDI_HEIGHT) / 1000;   // kilopixel per second
-
-  Serial.print(fps);                         Serial.print(" fps  ");
-  Serial.print(kpps);                        Serial.print(" kpps @");
-  Serial.print(LEDI_WIDTH*LEDI_HEIGHT);                 Serial.print(" LEDs  ");  
-  Serial.print(round(total));                Serial.print(" µs per frame  Rendering: ");
-  Serial.print(round((calc * 100) / total)); Serial.print("%  Sending data: ");
-  Serial.print(round((push * 100) / total)); Serial.print("%  (");
-  Serial.print(round(calc));                 Serial.print(" + ");
-  Serial.print(round(push));                 Serial.println(" µs) ");
-}
\ No newline at end of file
+  const AnimaxGrid &grid = *Ctx.grid;
+  uint16_t x0[LEDI_WIDTH], x1[LEDI_WIDTH];
+  uint16_t fx[LEDI_WIDTH];
+  CRGB     row[LEDI_WIDTH];
+  int32_t  s, max;
+  uint16_t x, y, y0, y1, fy;
+
+  if (grid.shift == ANIMAX_QUALITY_FULL) {
+    return;
+  }
+
+  // source position of a pixel center in 1/256 samples
+  max = (grid.width - 1) << 8;
+  for (x = 0; x < LEDI_WIDTH; x++) {
+    s = (((2 * x + 1) << 7) >> grid.shift) - 128;
+    s = (s < 0) ? 0 : (s > max) ? max : s;
+    x0[x] = s >> 8;
+    x1[x] = (x0[x] + 1 < grid.width) ? x0[x] + 1 : x0[x];
+    fx[x] = s & 0xFF;
+  }
+
+  max = (grid.height - 1) << 8;
+  for (y = 0; y < LEDI_HEIGHT; y++) {
+    s = (((2 * y + 1) << 7) >> grid.shift) - 128;
+    s = (s < 0) ? 0 : (s > max) ? max : s;
+    y0 = s >> 8;
+    y1 = (y0 + 1 < grid.height) ? y0 + 1 : y0;
+    fy = s & 0xFF;
+
+    const CRGB *row0 = &Ctx.lowRes[(uint32_t)y0 * grid.width];
+    const CRGB *row1 = &Ctx.lowRes[(uint32_t)y1 * grid.width];
+
+    for (x = 0; x < LEDI_WIDTH; x++) {
+      const CRGB &a = row0[x0[x]], &b = row0[x1[x]];
+      const CRGB &c = row1[x0[x]], &d = row1[x1[x]];
+      uint32_t wx = fx[x], wy = fy;
+      uint32_t top, bot;
+      CRGB    &out = row[x];
+
+      top = a.r * (256 - wx) + b.r * wx;
+      bot = c.r * (256 - wx) + d.r * wx;
+      out.r = (top * (256 - wy) + bot * wy + 0x8000) >> 16;
+      top = a.g * (256 - wx) + b.g * wx;
+      bot = c.g * (256 - wx) + d.g * wx;
+      out.g = (top * (256 - wy) + bot * wy + 0x8000) >> 16;
+      top = a.b * (256 - wx) + b.b * wx;
+      bot = c.b * (256 - wx) + d.b * wx;
+      out.b = (top * (256 - wy) + bot * wy + 0x8000) >> 16;
+    }
+    ANI_WriteSpan(Ap, pXY(0, y), row, LEDI_WIDTH);
+  }
+}
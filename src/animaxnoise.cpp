@@ -0,0 +1,1213 @@
+/* ********************************************************************************************
+ * animaxnoise.cpp
+ *
+ * Author: Shawn Saenger
+ *
+ * Created: Oct 16, 2026
+ *
+ * Description: Perlin noise kernels for ANIMartRIX. The reference implementation is Ken
+ *              Perlin's improved noise as used by Stefan Petrick's ANIMartRIX. The batched
+ *              kernels produce the same values but work on arrays of coordinates so the
+ *              floor, fade and hash work runs in tight loops, or in SIMD lanes on host builds.
+ *
+ * ********************************************************************************************
+ */
+
+#include "../inc/animaxnoise.hpp"
+
+#if ANOISE_USE_SIMD
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define ANOISE_SIMD_AVX2
+#elif defined(__SSE4_1__)
+#include <smmintrin.h>
+#define ANOISE_SIMD_SSE41
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#define ANOISE_SIMD_NEON
+#endif
+#endif /* ANOISE_USE_SIMD */
+
+/* --------------------------------------------------------------------------------------------
+ *  MACROS
+ * --------------------------------------------------------------------------------------------
+ */
+#define NOISE_FADE(t) ((t) * (t) * (t) * ((t) * ((t) * 6 - 15) + 10))
+#define NOISE_LERP(t, a, b) ((a) + (t) * ((b) - (a)))
+
+/* Q16.16 versions of the above. Products are taken in 64 bits, a single SMULL on the M7 */
+#define NOISE_QMUL(a, b) ((int32_t)(((int64_t)(a) * (b)) >> 16))
+#define NOISE_FADE_Q16(t) NOISE_QMUL(NOISE_QMUL(NOISE_QMUL(t, t), t),                        \
+                                     NOISE_QMUL(t, 6 * (t) - 15 * ANOISE_Q16_ONE)             \
+                                     + 10 * ANOISE_Q16_ONE)
+#define NOISE_LERP_Q16(t, a, b) ((a) + NOISE_QMUL(t, (b) - (a)))
+
+/* Lattice cells ANOISE_FbmBatch() shifts each octave by, so the octaves don't all share a
+ * lattice corner at the origin
+ */
+#define NOISE_FBM_SHIFT_X 37
+#define NOISE_FBM_SHIFT_Y 91
+#define NOISE_FBM_SHIFT_Z 53
+
+/* Samples ANOISE_FbmBatch() carries from one octave to the next on the stack */
+#define NOISE_FBM_CHUNK 64
+
+/* Times ANOISE_ReportAccuracy() renders each batch of 64 samples for, to time it with micros() */
+#define NOISE_REPORT_REPEAT 32
+
+/* Skew and unskew factors between the cubic lattice and the simplex grid in 3D */
+#define NOISE_SIMPLEX_F3 (1.f / 3)
+#define NOISE_SIMPLEX_G3 (1.f / 6)
+
+/* Scales the sum of the 4 simplex corners so the spread of the values matches ANOISE_Pnoise().
+ * The textbook factor of 32 fills -1 to 1 with a standard deviation of 0.43, where Perlin noise
+ * has 0.27, so animations tuned for Perlin noise would come out with harsh contrast. Scaled to
+ * the same standard deviation, simplex noise stays within -0.62 to 0.62.
+ */
+#define NOISE_SIMPLEX_SCALE 20.3f
+
+/* --------------------------------------------------------------------------------------------
+ *  GLOBALS
+ * --------------------------------------------------------------------------------------------
+ */
+
+/* Ken Perlin's permutation table repeated twice so that the hash lookups of the 8 cube corners
+ * never need to be masked. The 4 trailing pad bytes let the AVX2 kernel gather 32 bits at
+ * any index and mask off the upper bytes.
+ */
+static const uint8_t perm[512 + 4] = {
+    151,160,137, 91, 90, 15,131, 13,201, 95, 96, 53,194,233,  7,225,
+    140, 36,103, 30, 69,142,  8, 99, 37,240, 21, 10, 23,190,  6,148,
+    247,120,234, 75,  0, 26,197, 62, 94,252,219,203,117, 35, 11, 32,
+     57,177, 33, 88,237,149, 56, 87,174, 20,125,136,171,168, 68,175,
+     74,165, 71,134,139, 48, 27,166, 77,146,158,231, 83,111,229,122,
+     60,211,133,230,220,105, 92, 41, 55, 46,245, 40,244,102,143, 54,
+     65, 25, 63,161,  1,216, 80, 73,209, 76,132,187,208, 89, 18,169,
+    200,196,135,130,116,188,159, 86,164,100,109,198,173,186,  3, 64,
+     52,217,226,250,124,123,  5,202, 38,147,118,126,255, 82, 85,212,
+    207,206, 59,227, 47, 16, 58, 17,182,189, 28, 42,223,183,170,213,
+    119,248,152,  2, 44,154,163, 70,221,153,101,155,167, 43,172,  9,
+    129, 22, 39,253, 19, 98,108,110, 79,113,224,232,178,185,112,104,
+    218,246, 97,228,251, 34,242,193,238,210,144, 12,191,179,162,241,
+     81, 51,145,235,249, 14,239,107, 49,192,214, 31,181,199,106,157,
+    184, 84,204,176,115,121, 50, 45,127,  4,150,254,138,236,205, 93,
+    222,114, 67, 29, 24, 72,243,141,128,195, 78, 66,215, 61,156,180,
+    151,160,137, 91, 90, 15,131, 13,201, 95, 96, 53,194,233,  7,225,
+    140, 36,103, 30, 69,142,  8, 99, 37,240, 21, 10, 23,190,  6,148,
+    247,120,234, 75,  0, 26,197, 62, 94,252,219,203,117, 35, 11, 32,
+     57,177, 33, 88,237,149, 56, 87,174, 20,125,136,171,168, 68,175,
+     74,165, 71,134,139, 48, 27,166, 77,146,158,231, 83,111,229,122,
+     60,211,133,230,220,105, 92, 41, 55, 46,245, 40,244,102,143, 54,
+     65, 25, 63,161,  1,216, 80, 73,209, 76,132,187,208, 89, 18,169,
+    200,196,135,130,116,188,159, 86,164,100,109,198,173,186,  3, 64,
+     52,217,226,250,124,123,  5,202, 38,147,118,126,255, 82, 85,212,
+    207,206, 59,227, 47, 16, 58, 17,182,189, 28, 42,223,183,170,213,
+    119,248,152,  2, 44,154,163, 70,221,153,101,155,167, 43,172,  9,
+    129, 22, 39,253, 19, 98,108,110, 79,113,224,232,178,185,112,104,
+    218,246, 97,228,251, 34,242,193,238,210,144, 12,191,179,162,241,
+     81, 51,145,235,249, 14,239,107, 49,192,214, 31,181,199,106,157,
+    184, 84,204,176,115,121, 50, 45,127,  4,150,254,138,236,205, 93,
+    222,114, 67, 29, 24, 72,243,141,128,195, 78, 66,215, 61,156,180,
+      0,  0,  0,  0
+};
+
+/* The 12 gradient directions of AnoiseGrad() by the low 4 bits of the hash, for kernels that
+ * take the dot product instead of branching on the hash
+ */
+static const float grad3[16][3] = {
+    { 1,  1,  0}, {-1,  1,  0}, { 1, -1,  0}, {-1, -1,  0},
+    { 1,  0,  1}, {-1,  0,  1}, { 1,  0, -1}, {-1,  0, -1},
+    { 0,  1,  1}, { 0, -1,  1}, { 0,  1, -1}, { 0, -1, -1},
+    { 1,  1,  0}, { 0, -1,  1}, {-1,  1,  0}, { 0, -1, -1}
+};
+
+/* Tileable noise volume for ANOISE_SRC_VOLUME, indexed [z][y][x]. -1 to 1 is stored as 0-255 */
+static uint8_t *volume;
+
+/* --------------------------------------------------------------------------------------------
+ *  PROTOTYPES
+ * --------------------------------------------------------------------------------------------
+ */
+static inline float AnoiseGrad(int Hash, float X, float Y, float Z);
+static inline float AnoiseSample(float X, float Y, float Z);
+static inline float AnoiseLattice(int Xi, int Yi, int Zi, float X, float Y, float Z);
+static inline void AnoiseHashCell(int Xi, int Yi, int Zi, uint8_t *Hash);
+static inline float AnoiseBlendCell(const uint8_t *Hash, float U, float V, float W,
+                                    float X, float Y, float Z);
+static inline float AnoiseSimplex(float X, float Y, float Z);
+static inline float AnoiseSimplexCorner(int Hash, float X, float Y, float Z);
+static inline int32_t AnoiseGradQ16(int Hash, int32_t X, int32_t Y, int32_t Z);
+static inline int32_t AnoiseSampleQ16(int32_t X, int32_t Y, int32_t Z);
+static float AnoiseSamplePeriodic(float X, float Y, float Z, int Period, int PeriodZ);
+static inline int32_t AnoiseVolumeCoord(float X, uint32_t Size);
+#if defined(ANOISE_SIMD_AVX2) || defined(ANOISE_SIMD_SSE41) || defined(ANOISE_SIMD_NEON)
+static uint32_t AnoiseBatchSimd(const float *X, const float *Y, const float *Z, float *Out,
+                                uint32_t Count);
+#endif
+
+/* --------------------------------------------------------------------------------------------
+ *  PUBLIC FUNCTIONS
+ * --------------------------------------------------------------------------------------------
+ */
+
+/* --------------------------------------------------------------------------------------------
+ *                 ANOISE_Pnoise()
+ * --------------------------------------------------------------------------------------------
+ * Description:    Calculates 3D Perlin noise for a single point.
+ *
+ * Parameters:     X, Y, Z - Coordinates of the point
+ *
+ * Returns:        Noise value, roughly -1 to 1
+ */
+float ANOISE_Pnoise(float X, float Y, float Z)
+{
+    return AnoiseSample(X, Y, Z);
+}
+
+/* --------------------------------------------------------------------------------------------
+ *                 ANOISE_PnoiseBatch()
+ * --------------------------------------------------------------------------------------------
+ * Description:    Calculates 3D Perlin noise for an array of points. Typically called with a
+ *                 row of LEDI_WIDTH samples, but any count works, including a whole frame.
+ *                 The arrays can't overlap Out.
+ *
+ * Parameters:     X, Y, Z - Arrays of Count coordinates
+ *                 Out - Array receiving the Count noise values
+ *                 Count - Number of samples
+ *
+ * Returns:        void
+ */
+void ANOISE_PnoiseBatch(const float *X, const float *Y, const float *Z, float *Out,
+                        uint32_t Count)
+{
+    uint32_t i = 0;
+
+#if defined(ANOISE_SIMD_AVX2) || defined(ANOISE_SIMD_SSE41) || defined(ANOISE_SIMD_NEON)
+    i = AnoiseBatchSimd(X, Y, Z, Out, Count);
+#endif
+    /* Scalar kernel. Handles the whole batch on the M7 and the remainder on host builds */
+    for (; i < Count; i++) {
+        Out[i] = AnoiseSample(X[i], Y[i], Z[i]);
+    }
+}
+
+/* --------------------------------------------------------------------------------------------
+ *                 ANOISE_FbmBatch()
+ * --------------------------------------------------------------------------------------------
+ * Description:    Calculates Octaves octaves of Perlin noise summed as fractal Brownian motion
+ *                 for an array of points. Each octave doubles the frequency and multiplies the
+ *                 amplitude by Gain. With Turbulence set the octaves are summed as |noise|,
+ *                 which gives the creased look of fire and marble.
+ *
+ *                 All octaves of a sample are evaluated in one pass. Because the lacunarity is
+ *                 exactly 2, the lattice cell and fraction of the next octave follow from the
+ *                 current ones with a shift and a compare, so the floor and the float to int
+ *                 conversions run once per sample instead of once per octave. Within an
+ *                 octave the corner hashes of a lattice cell and the fade of z are reused by
+ *                 the following samples of the row that fall in the same cell or share z.
+ *                 The sum is normalized by the sum of the amplitudes.
+ *
+ * Parameters:     X, Y, Z - Arrays of Count coordinates of the first octave
+ *                 Out - Array receiving the Count values. -1 to 1, or 0 to 1 for Turbulence
+ *                 Count - Number of samples
+ *                 Octaves - Number of octaves. 0 is taken as 1
+ *                 Gain - Amplitude of each octave relative to the one before, typically 0.5
+ *                 Turbulence - true to sum |noise|
+ *
+ * Returns:        void
+ */
+void ANOISE_FbmBatch(const float *X, const float *Y, const float *Z, float *Out,
+                     uint32_t Count, uint8_t Octaves, float Gain, bool Turbulence)
+{
+    int      xi[NOISE_FBM_CHUNK], yi[NOISE_FBM_CHUNK], zi[NOISE_FBM_CHUNK];
+    float    x[NOISE_FBM_CHUNK], y[NOISE_FBM_CHUNK], z[NOISE_FBM_CHUNK];
+    float    octave[NOISE_FBM_CHUNK];
+#if defined(ANOISE_SIMD_AVX2) || defined(ANOISE_SIMD_SSE41) || defined(ANOISE_SIMD_NEON)
+    float    ox[NOISE_FBM_CHUNK], oy[NOISE_FBM_CHUNK], oz[NOISE_FBM_CHUNK];
+#endif
+    float    norm = 0, amp = 1, lastZ, w = 0;
+    uint32_t base, i, n;
+    uint8_t  hash[8] = {0};
+    uint8_t  o;
+    int      c, cellX, cellY = 0, cellZ = 0;
+
+    if (Octaves == 0) {
+        Octaves = 1;
+    }
+    for (o = 0; o < Octaves; o++) {
+        norm += amp;
+        amp  *= Gain;
+    }
+    norm = 1 / norm;
+
+    for (base = 0; base < Count; base += n) {
+        n = min(Count - base, (uint32_t)NOISE_FBM_CHUNK);
+
+        /* Lattice cells and fractions of the first octave, the only floor of the batch */
+        for (i = 0; i < n; i++) {
+            xi[i] = (int)X[base + i];
+            yi[i] = (int)Y[base + i];
+            zi[i] = (int)Z[base + i];
+            xi[i] -= (X[base + i] < (float)xi[i]);
+            yi[i] -= (Y[base + i] < (float)yi[i]);
+            zi[i] -= (Z[base + i] < (float)zi[i]);
+            x[i] = X[base + i] - (float)xi[i];
+            y[i] = Y[base + i] - (float)yi[i];
+            z[i] = Z[base + i] - (float)zi[i];
+            Out[base + i] = 0;
+        }
+
+        amp = norm;
+        for (o = 0;;) {
+            i = 0;
+#if defined(ANOISE_SIMD_AVX2) || defined(ANOISE_SIMD_SSE41) || defined(ANOISE_SIMD_NEON)
+            /* Host builds hand the lattice work to the vector kernel. Cell + fraction is exact */
+            for (; i < n; i++) {
+                ox[i] = (float)(xi[i] & 0xFF) + x[i];
+                oy[i] = (float)(yi[i] & 0xFF) + y[i];
+                oz[i] = (float)(zi[i] & 0xFF) + z[i];
+            }
+            i = AnoiseBatchSimd(ox, oy, oz, octave, n);
+#endif
+            /* Neighbouring samples of a row mostly share a lattice cell in the low octaves
+             * and a z in every octave, so the corner hashes and the z fade carry over from
+             * the sample before until they change
+             */
+            cellX = -1;
+            lastZ = -1;
+            for (; i < n; i++) {
+                if ((xi[i] & 0xFF) != cellX || (yi[i] & 0xFF) != cellY ||
+                    (zi[i] & 0xFF) != cellZ) {
+                    cellX = xi[i] & 0xFF;
+                    cellY = yi[i] & 0xFF;
+                    cellZ = zi[i] & 0xFF;
+                    AnoiseHashCell(cellX, cellY, cellZ, hash);
+                }
+                if (z[i] != lastZ) {
+                    lastZ = z[i];
+                    w = NOISE_FADE(lastZ);
+                }
+                octave[i] = AnoiseBlendCell(hash, NOISE_FADE(x[i]), NOISE_FADE(y[i]), w,
+                                            x[i], y[i], z[i]);
+            }
+
+            if (Turbulence) {
+                for (i = 0; i < n; i++) {
+                    Out[base + i] += amp * fabsf(octave[i]);
+                }
+            } else {
+                for (i = 0; i < n; i++) {
+                    Out[base + i] += amp * octave[i];
+                }
+            }
+            if (++o >= Octaves) {
+                break;
+            }
+            amp *= Gain;
+
+            /* Doubling is exact in float, so this is the floor of 2 * (cell + fraction) */
+            for (i = 0; i < n; i++) {
+                x[i] *= 2;
+                y[i] *= 2;
+                z[i] *= 2;
+                c = (x[i] >= 1);  x[i] -= c;  xi[i] = 2 * (xi[i] & 0xFF) + c + NOISE_FBM_SHIFT_X;
+                c = (y[i] >= 1);  y[i] -= c;  yi[i] = 2 * (yi[i] & 0xFF) + c + NOISE_FBM_SHIFT_Y;
+                c = (z[i] >= 1);  z[i] -= c;  zi[i] = 2 * (zi[i] & 0xFF) + c + NOISE_FBM_SHIFT_Z;
+            }
+        }
+    }
+}
+
+/* --------------------------------------------------------------------------------------------
+ *                 ANOISE_Snoise()
+ * --------------------------------------------------------------------------------------------
+ * Description:    Calculates 3D simplex noise for a single point. Simplex noise sums the 4
+ *                 corners of the tetrahedron the point is in instead of blending the 8 corners
+ *                 of a cube, and has no grid aligned artifacts. The values are scaled to the
+ *                 spread of ANOISE_Pnoise() so the two can be swapped under the same low limits.
+ *
+ * Parameters:     X, Y, Z - Coordinates of the point
+ *
+ * Returns:        Noise value, -0.62 to 0.62
+ */
+float ANOISE_Snoise(float X, float Y, float Z)
+{
+    return AnoiseSimplex(X, Y, Z);
+}
+
+/* --------------------------------------------------------------------------------------------
+ *                 ANOISE_SnoiseBatch()
+ * --------------------------------------------------------------------------------------------
+ * Description:    Calculates 3D simplex noise for an array of points. The arrays can't overlap
+ *                 Out.
+ *
+ * Parameters:     X, Y, Z - Arrays of Count coordinates
+ *                 Out - Array receiving the Count noise values
+ *                 Count - Number of samples
+ *
+ * Returns:        void
+ */
+void ANOISE_SnoiseBatch(const float *X, const float *Y, const float *Z, float *Out,
+                        uint32_t Count)
+{
+    uint32_t i;
+
+    for (i = 0; i < Count; i++) {
+        Out[i] = AnoiseSimplex(X[i], Y[i], Z[i]);
+    }
+}
+
+/* --------------------------------------------------------------------------------------------
+ *                 ANOISE_PnoiseQ16()
+ * --------------------------------------------------------------------------------------------
+ * Description:    Calculates 3D Perlin noise for a single point in Q16.16 fixed point. Use
+ *                 ANOISE_FloatToQ16() to convert float coordinates.
+ *
+ * Parameters:     X, Y, Z - Q16.16 coordinates of the point
+ *
+ * Returns:        Q16.16 noise value, roughly -ANOISE_Q16_ONE to ANOISE_Q16_ONE
+ */
+int32_t ANOISE_PnoiseQ16(int32_t X, int32_t Y, int32_t Z)
+{
+    return AnoiseSampleQ16(X, Y, Z);
+}
+
+/* --------------------------------------------------------------------------------------------
+ *                 ANOISE_PnoiseBatchQ16()
+ * --------------------------------------------------------------------------------------------
+ * Description:    Calculates 3D Perlin noise for an array of Q16.16 points. Same as
+ *                 ANOISE_PnoiseBatch() but without any float math.
+ *
+ * Parameters:     X, Y, Z - Arrays of Count Q16.16 coordinates
+ *                 Out - Array receiving the Count Q16.16 noise values
+ *                 Count - Number of samples
+ *
+ * Returns:        void
+ */
+void ANOISE_PnoiseBatchQ16(const int32_t *X, const int32_t *Y, const int32_t *Z, int32_t *Out,
+                           uint32_t Count)
+{
+    uint32_t i;
+
+    for (i = 0; i < Count; i++) {
+        Out[i] = AnoiseSampleQ16(X[i], Y[i], Z[i]);
+    }
+}
+
+/* --------------------------------------------------------------------------------------------
+ *                 ANOISE_VolumeInit()
+ * --------------------------------------------------------------------------------------------
+ * Description:    Allocates and fills the noise volume used by ANOISE_SRC_VOLUME. The volume
+ *                 is sampled from Perlin noise with the lattice wrapped to the volume's
+ *                 period, so it tiles seamlessly in all 3 directions. Only call once.
+ *
+ * Parameters:     None
+ *
+ * Returns:        true if successful. false otherwise.
+ */
+bool ANOISE_VolumeInit(void)
+{
+    const int   period = ANOISE_VOLUME_SIZE / ANOISE_VOLUME_RES;
+    const int   periodZ = ANOISE_VOLUME_DEPTH / ANOISE_VOLUME_RES;
+    const float step = 1.f / ANOISE_VOLUME_RES;
+    uint32_t    x, y, z, i;
+    float       n;
+
+    volume = (uint8_t*)malloc(ANOISE_VOLUME_SIZE * ANOISE_VOLUME_SIZE * ANOISE_VOLUME_DEPTH);
+    if (volume == 0) {
+        Serial.println("Could not allocate memory for noise volume");
+        return false;
+    }
+
+    i = 0;
+    for (z = 0; z < ANOISE_VOLUME_DEPTH; z++) {
+        for (y = 0; y < ANOISE_VOLUME_SIZE; y++) {
+            for (x = 0; x < ANOISE_VOLUME_SIZE; x++) {
+                n = AnoiseSamplePeriodic(x * step, y * step, z * step, period, periodZ);
+                n = (n + 1) * 127.5f + 0.5f;
+                volume[i++] = (n < 0) ? 0 : (n > 255) ? 255 : (uint8_t)n;
+            }
+        }
+    }
+    return true;
+}
+
+/* --------------------------------------------------------------------------------------------
+ *                 ANOISE_VolumeBatch()
+ * --------------------------------------------------------------------------------------------
+ * Description:    Samples the noise volume with trilinear interpolation for an array of
+ *                 points. Falls back to ANOISE_PnoiseBatch() if the volume was never built.
+ *
+ * Parameters:     X, Y, Z - Arrays of Count coordinates, in the same units as ANOISE_Pnoise()
+ *                 Out - Array receiving the Count noise values
+ *                 Count - Number of samples
+ *
+ * Returns:        void
+ */
+void ANOISE_VolumeBatch(const float *X, const float *Y, const float *Z, float *Out,
+                        uint32_t Count)
+{
+    const uint32_t mask = ANOISE_VOLUME_SIZE - 1;
+    const uint32_t maskZ = ANOISE_VOLUME_DEPTH - 1;
+    const uint32_t rowStride = ANOISE_VOLUME_SIZE;
+    const uint32_t planeStride = ANOISE_VOLUME_SIZE * ANOISE_VOLUME_SIZE;
+    uint32_t i;
+
+    if (volume == 0) {
+        ANOISE_PnoiseBatch(X, Y, Z, Out, Count);
+        return;
+    }
+
+    for (i = 0; i < Count; i++) {
+        /* Voxel coordinates in 24.8 fixed point */
+        int32_t  qx = AnoiseVolumeCoord(X[i], ANOISE_VOLUME_SIZE);
+        int32_t  qy = AnoiseVolumeCoord(Y[i], ANOISE_VOLUME_SIZE);
+        int32_t  qz = AnoiseVolumeCoord(Z[i], ANOISE_VOLUME_DEPTH);
+        uint32_t x0 = (qx >> 8) & mask, x1 = (x0 + 1) & mask;
+        uint32_t y0 = ((qy >> 8) & mask) * rowStride, y1 = (((qy >> 8) + 1) & mask) * rowStride;
+        uint32_t z0 = ((qz >> 8) & maskZ) * planeStride;
+        uint32_t z1 = (((qz >> 8) + 1) & maskZ) * planeStride;
+        int32_t  fx = qx & 0xFF, fy = qy & 0xFF, fz = qz & 0xFF;
+        int32_t  c00, c01, c10, c11, c0, c1;
+        int64_t  c;
+
+        /* Lerp along x (8 fraction bits), then y (16), then z (24) */
+        c00 = (volume[z0 + y0 + x0] << 8) + fx * (volume[z0 + y0 + x1] - volume[z0 + y0 + x0]);
+        c01 = (volume[z0 + y1 + x0] << 8) + fx * (volume[z0 + y1 + x1] - volume[z0 + y1 + x0]);
+        c10 = (volume[z1 + y0 + x0] << 8) + fx * (volume[z1 + y0 + x1] - volume[z1 + y0 + x0]);
+        c11 = (volume[z1 + y1 + x0] << 8) + fx * (volume[z1 + y1 + x1] - volume[z1 + y1 + x0]);
+        c0  = (c00 << 8) + fy * (c01 - c00);
+        c1  = (c10 << 8) + fy * (c11 - c10);
+
+        c   = ((int64_t)c0 << 8) + (int64_t)fz * (c1 - c0);
+
+        Out[i] = c * (1.f / (127.5f * 16777216)) - 1;
+    }
+}
+
+#if ANOISE_DIAGNOSTICS
+/* --------------------------------------------------------------------------------------------
+ *                 ANOISE_ReportAccuracy()
+ * --------------------------------------------------------------------------------------------
+ * Description:    Renders Samples pseudo random points with the float and the fixed point
+ *                 noise and prints the error of the fixed point engine in LSBs of the 0-255
+ *                 range the animations map noise to, along with the time per sample of
+ *                 both engines. The fixed point time includes the conversion of the float
+ *                 coordinates to Q16.16 and of the result back to float, which the ANIMAX
+ *                 layers pay for every sample. Each batch is timed NOISE_REPORT_REPEAT times
+ *                 over so the resolution of micros() doesn't swamp it.
+ *
+ * Parameters:     Samples - Number of points to compare
+ *
+ * Returns:        void
+ */
+void ANOISE_ReportAccuracy(uint32_t Samples)
+{
+    static float   x[64], y[64], z[64], ref[64];
+    static int32_t qx[64], qy[64], qz[64], q[64];
+    uint32_t seed = 0x1234567;
+    uint32_t done, i, n, r;
+    uint32_t floatUs = 0, fixedUs = 0, start;
+    float    err, maxErr = 0, sumErr = 0;
+    float    fixed[64];
+
+    for (done = 0; done < Samples; done += n) {
+        n = min(Samples - done, (uint32_t)64);
+        for (i = 0; i < n; i++) {
+            /* Spread the points over -512 to 512 so the wrap in ANOISE_FloatToQ16() is used */
+            seed = seed * 1664525 + 1013904223;
+            x[i] = (int32_t)seed / 4194304.f;
+            seed = seed * 1664525 + 1013904223;
+            y[i] = (int32_t)seed / 4194304.f;
+            seed = seed * 1664525 + 1013904223;
+            z[i] = (int32_t)seed / 4194304.f;
+        }
+
+        start = micros();
+        for (r = 0; r < NOISE_REPORT_REPEAT; r++) {
+            ANOISE_PnoiseBatch(x, y, z, ref, n);
+        }
+        floatUs += micros() - start;
+
+        start = micros();
+        for (r = 0; r < NOISE_REPORT_REPEAT; r++) {
+            for (i = 0; i < n; i++) {
+                qx[i] = ANOISE_FloatToQ16(x[i]);
+                qy[i] = ANOISE_FloatToQ16(y[i]);
+                qz[i] = ANOISE_FloatToQ16(z[i]);
+            }
+            ANOISE_PnoiseBatchQ16(qx, qy, qz, q, n);
+            for (i = 0; i < n; i++) {
+                fixed[i] = q[i] * (1.f / ANOISE_Q16_ONE);
+            }
+        }
+        fixedUs += micros() - start;
+
+        for (i = 0; i < n; i++) {
+            /* Noise of -1 to 1 maps to 0-255 when low_limit is -1, the widest mapping used */
+            err = fabsf(ref[i] - fixed[i]) * 127.5f;
+            sumErr += err;
+            if (err > maxErr) {
+                maxErr = err;
+            }
+        }
+    }
+
+    Serial.print("Noise Q16.16 vs float over ");   Serial.print(Samples);
+    Serial.print(" samples: max err ");             Serial.print(maxErr, 3);
+    Serial.print(" LSB, mean err ");                Serial.print(sumErr / Samples, 4);
+    Serial.print(" LSB  float ");
+    Serial.print((float)floatUs / ((float)Samples * NOISE_REPORT_REPEAT), 4);
+    Serial.print(" us/sample, fixed ");
+    Serial.print((float)fixedUs / ((float)Samples * NOISE_REPORT_REPEAT), 4);
+    Serial.println(" us/sample");
+}
+/* --------------------------------------------------------------------------------------------
+ *                 ANOISE_ReportFbm()
+ * --------------------------------------------------------------------------------------------
+ * Description:    Times ANOISE_FbmBatch() for 1 to ANOISE_FBM_MAX_OCTAVES octaves against
+ *                 stacking one ANOISE_PnoiseBatch() call per octave over the same row of
+ *                 points, the way an animation would without the fBm kernel, and prints the
+ *                 time per sample per octave of both along with the largest difference
+ *                 between them. Runs once over scattered points and once over a row the way
+ *                 a layer samples it, 0.08 apart at one z, where neighbouring samples share
+ *                 lattice cells.
+ *
+ * Parameters:     Samples - Number of samples to time per octave count. Rounded up to whole
+ *                           rows of LEDI_WIDTH
+ *
+ * Returns:        void
+ */
+void ANOISE_ReportFbm(uint32_t Samples)
+{
+    static float x[LEDI_WIDTH], y[LEDI_WIDTH], z[LEDI_WIDTH];
+    static float ox[LEDI_WIDTH], oy[LEDI_WIDTH], oz[LEDI_WIDTH];
+    static float n[LEDI_WIDTH], sum[LEDI_WIDTH], fbm[LEDI_WIDTH];
+    uint32_t seed = 0x7654321;
+    uint32_t rows = (Samples + LEDI_WIDTH - 1) / LEDI_WIDTH;
+    uint32_t r, i;
+    uint32_t fbmUs, stackUs, start;
+    uint8_t  octaves, o, pass;
+    float    amp, norm, err, maxErr, total;
+
+    for (pass = 0; pass < 2; pass++) {
+        for (i = 0; i < LEDI_WIDTH; i++) {
+            if (pass) {
+                /* A layer row at the 0.08 scale of the animations */
+                x[i] = 5.3f + i * 0.08f;
+                y[i] = 2.9f + i * 0.03f;
+                z[i] = 1.7f;
+                continue;
+            }
+            /* -32 to 32, the range the animations sample noise at */
+            seed = seed * 1664525 + 1013904223;
+            x[i] = (int32_t)seed / 67108864.f;
+            seed = seed * 1664525 + 1013904223;
+            y[i] = (int32_t)seed / 67108864.f;
+            seed = seed * 1664525 + 1013904223;
+            z[i] = (int32_t)seed / 67108864.f;
+        }
+
+        for (octaves = 1; octaves <= ANOISE_FBM_MAX_OCTAVES; octaves++) {
+            /* Every row moves the points in z so the timing doesn't replay the same lattice
+             * cells
+             */
+            start = micros();
+            for (r = 0; r < rows; r++) {
+                for (i = 0; i < LEDI_WIDTH; i++) {
+                    oz[i] = z[i] + r * 0.37f;
+                }
+                ANOISE_FbmBatch(x, y, oz, fbm, LEDI_WIDTH, octaves, 0.5f, false);
+            }
+            fbmUs = micros() - start;
+
+            start = micros();
+            for (r = 0; r < rows; r++) {
+                amp = 1;
+                norm = 0;
+                for (i = 0; i < LEDI_WIDTH; i++) {
+                    ox[i] = x[i];
+                    oy[i] = y[i];
+                    oz[i] = z[i] + r * 0.37f;
+                    sum[i] = 0;
+                }
+                for (o = 0; o < octaves; o++) {
+                    ANOISE_PnoiseBatch(ox, oy, oz, n, LEDI_WIDTH);
+                    for (i = 0; i < LEDI_WIDTH; i++) {
+                        sum[i] += amp * n[i];
+                        ox[i] = 2 * ox[i] + NOISE_FBM_SHIFT_X;
+                        oy[i] = 2 * oy[i] + NOISE_FBM_SHIFT_Y;
+                        oz[i] = 2 * oz[i] + NOISE_FBM_SHIFT_Z;
+                    }
+                    norm += amp;
+                    amp *= 0.5f;
+                }
+                for (i = 0; i < LEDI_WIDTH; i++) {
+                    sum[i] /= norm;
+                }
+            }
+            stackUs = micros() - start;
+
+            maxErr = 0;
+            for (i = 0; i < LEDI_WIDTH; i++) {
+                err = fabsf(sum[i] - fbm[i]) * 127.5f;
+                if (err > maxErr) {
+                    maxErr = err;
+                }
+            }
+
+            total = (float)rows * LEDI_WIDTH * octaves;
+            Serial.print(pass ? "fBm row " : "fBm scattered ");
+            Serial.print(octaves);
+            Serial.print(" octaves: one pass ");          Serial.print(fbmUs / total, 3);
+            Serial.print(" us/sample/octave, stacked ");  Serial.print(stackUs / total, 3);
+            Serial.print(" us/sample/octave, max diff "); Serial.print(maxErr, 3);
+            Serial.println(" LSB");
+        }
+    }
+}
+/* --------------------------------------------------------------------------------------------
+ *                 ANOISE_ReportSimplex()
+ * --------------------------------------------------------------------------------------------
+ * Description:    Times ANOISE_SnoiseBatch() against ANOISE_PnoiseBatch() over the samples of
+ *                 one layer of a full LEDI_WIDTH x LEDI_HEIGHT frame, and of the half and
+ *                 quarter resolution frames of the reduced ANIMAX qualities, rendered a row at
+ *                 a time. Prints the time per frame of both and the standard deviation of the
+ *                 values, which should match.
+ *
+ * Parameters:     None
+ *
+ * Returns:        void
+ */
+void ANOISE_ReportSimplex(void)
+{
+    static float x[LEDI_WIDTH], y[LEDI_WIDTH], z[LEDI_WIDTH], n[LEDI_WIDTH];
+    uint32_t perlinUs, simplexUs, start;
+    uint32_t width, height, r, i, div;
+    float    perlinSq, simplexSq;
+
+    for (div = 1; div <= 4; div *= 2) {
+        width = LEDI_WIDTH / div;
+        height = LEDI_HEIGHT / div;
+        perlinUs = simplexUs = 0;
+        perlinSq = simplexSq = 0;
+
+        /* A zoomed in layer, like most animations render */
+        for (r = 0; r < height; r++) {
+            for (i = 0; i < width; i++) {
+                x[i] = i * div * 0.1f;
+                y[i] = r * div * 0.1f;
+                z[i] = 7.3f;
+            }
+
+            start = micros();
+            ANOISE_PnoiseBatch(x, y, z, n, width);
+            perlinUs += micros() - start;
+            for (i = 0; i < width; i++) {
+                perlinSq += n[i] * n[i];
+            }
+
+            start = micros();
+            ANOISE_SnoiseBatch(x, y, z, n, width);
+            simplexUs += micros() - start;
+            for (i = 0; i < width; i++) {
+                simplexSq += n[i] * n[i];
+            }
+        }
+
+        perlinSq = sqrtf(perlinSq / (width * height));
+        simplexSq = sqrtf(simplexSq / (width * height));
+        Serial.print("Noise ");                 Serial.print(width);
+        Serial.print("x");                      Serial.print(height);
+        Serial.print(": perlin ");              Serial.print(perlinUs);
+        Serial.print(" us, simplex ");          Serial.print(simplexUs);
+        Serial.print(" us  std dev perlin ");   Serial.print(perlinSq, 3);
+        Serial.print(", simplex ");             Serial.print(simplexSq, 3);
+        Serial.println();
+    }
+}
+#endif /* ANOISE_DIAGNOSTICS */
+
+/* --------------------------------------------------------------------------------------------
+ *  PRIVATE FUNCTIONS
+ * --------------------------------------------------------------------------------------------
+ */
+
+float AnoiseGrad(int Hash, float X, float Y, float Z)
+{
+    int    h = Hash & 15;          /* CONVERT LO 4 BITS OF HASH CODE */
+    float  u = h < 8 ? X : Y,      /* INTO 12 GRADIENT DIRECTIONS.   */
+           v = h < 4 ? Y : h == 12 || h == 14 ? X : Z;
+    return ((h & 1) == 0 ? u : -u) + ((h & 2) == 0 ? v : -v);
+}
+
+float AnoiseSample(float X, float Y, float Z)
+{
+    /* Floor without calling floorf(). Coordinates stay well inside the int range */
+    int   xi = (int)X, yi = (int)Y, zi = (int)Z;
+    xi -= (X < (float)xi);
+    yi -= (Y < (float)yi);
+    zi -= (Z < (float)zi);
+
+    return AnoiseLattice(xi & 0xFF, yi & 0xFF, zi & 0xFF,
+                         X - (float)xi,          /* FIND RELATIVE X,Y,Z */
+                         Y - (float)yi,          /* OF POINT IN CUBE.   */
+                         Z - (float)zi);
+}
+
+/* Noise of the point at fraction X, Y, Z inside lattice cell Xi, Yi, Zi. The cell is already
+ * wrapped to 0-255
+ */
+float AnoiseLattice(int Xi, int Yi, int Zi, float X, float Y, float Z)
+{
+    uint8_t hash[8];
+
+    AnoiseHashCell(Xi, Yi, Zi, hash);
+    return AnoiseBlendCell(hash, NOISE_FADE(X),       /* COMPUTE FADE CURVES */
+                                 NOISE_FADE(Y),       /* FOR EACH OF X,Y,Z.  */
+                                 NOISE_FADE(Z), X, Y, Z);
+}
+
+/* Hashes of the 8 corners of lattice cell Xi, Yi, Zi, already wrapped to 0-255. Ordered
+ * AA, BA, AB, BB and the same again one cell up in z
+ */
+void AnoiseHashCell(int Xi, int Yi, int Zi, uint8_t *Hash)
+{
+    int A  = perm[Xi] + Yi,              /* HASH COORDINATES OF */
+        AA = perm[A] + Zi,               /* THE 8 CUBE CORNERS  */
+        AB = perm[A + 1] + Zi,
+        B  = perm[Xi + 1] + Yi,
+        BA = perm[B] + Zi,
+        BB = perm[B + 1] + Zi;
+
+    Hash[0] = perm[AA];
+    Hash[1] = perm[BA];
+    Hash[2] = perm[AB];
+    Hash[3] = perm[BB];
+    Hash[4] = perm[AA + 1];
+    Hash[5] = perm[BA + 1];
+    Hash[6] = perm[AB + 1];
+    Hash[7] = perm[BB + 1];
+}
+
+/* Blends the gradients of the corners hashed by AnoiseHashCell() for the point at fraction
+ * X, Y, Z inside the cell, with U, V, W the fade curves of the fraction
+ */
+float AnoiseBlendCell(const uint8_t *Hash, float U, float V, float W, float X, float Y, float Z)
+{
+    return NOISE_LERP(W, NOISE_LERP(V, NOISE_LERP(U, AnoiseGrad(Hash[0], X, Y, Z),
+                                                     AnoiseGrad(Hash[1], X - 1, Y, Z)),
+                                       NOISE_LERP(U, AnoiseGrad(Hash[2], X, Y - 1, Z),
+                                                     AnoiseGrad(Hash[3], X - 1, Y - 1, Z))),
+                         NOISE_LERP(V, NOISE_LERP(U, AnoiseGrad(Hash[4], X, Y, Z - 1),
+                                                     AnoiseGrad(Hash[5], X - 1, Y, Z - 1)),
+                                       NOISE_LERP(U, AnoiseGrad(Hash[6], X, Y - 1, Z - 1),
+                                                     AnoiseGrad(Hash[7], X - 1, Y - 1, Z - 1))));
+}
+
+float AnoiseSimplex(float X, float Y, float Z)
+{
+    /* Skew the point to find the cube it is in. Its origin is corner 0 of the simplex */
+    float s = (X + Y + Z) * NOISE_SIMPLEX_F3;
+    float xs = X + s, ys = Y + s, zs = Z + s;
+    int   i = (int)xs, j = (int)ys, k = (int)zs;
+    i -= (xs < (float)i);
+    j -= (ys < (float)j);
+    k -= (zs < (float)k);
+
+    float t = (i + j + k) * NOISE_SIMPLEX_G3;
+    float x0 = X - (i - t),
+          y0 = Y - (j - t),
+          z0 = Z - (k - t);
+
+    /* The cube splits into 6 tetrahedra. Ranking the offsets picks the one the point is in:
+     * the 2nd corner steps along the largest offset, the 3rd along all but the smallest
+     */
+    int xy = (x0 >= y0), xz = (x0 >= z0), yz = (y0 >= z0);
+    int i1 = xy & xz,  j1 = (xy ^ 1) & yz,  k1 = (xz | yz) ^ 1;
+    int i2 = xy | xz,  j2 = (xy ^ 1) | yz,  k2 = (xz & yz) ^ 1;
+
+    i &= 0xFF;
+    j &= 0xFF;
+    k &= 0xFF;
+
+    float n = AnoiseSimplexCorner(perm[i + perm[j + perm[k]]], x0, y0, z0)
+            + AnoiseSimplexCorner(perm[i + i1 + perm[j + j1 + perm[k + k1]]],
+                                  x0 - i1 + NOISE_SIMPLEX_G3, y0 - j1 + NOISE_SIMPLEX_G3,
+                                  z0 - k1 + NOISE_SIMPLEX_G3)
+            + AnoiseSimplexCorner(perm[i + i2 + perm[j + j2 + perm[k + k2]]],
+                                  x0 - i2 + 2 * NOISE_SIMPLEX_G3, y0 - j2 + 2 * NOISE_SIMPLEX_G3,
+                                  z0 - k2 + 2 * NOISE_SIMPLEX_G3)
+            + AnoiseSimplexCorner(perm[i + 1 + perm[j + 1 + perm[k + 1]]],
+                                  x0 - 1 + 3 * NOISE_SIMPLEX_G3, y0 - 1 + 3 * NOISE_SIMPLEX_G3,
+                                  z0 - 1 + 3 * NOISE_SIMPLEX_G3);
+    return n * NOISE_SIMPLEX_SCALE;
+}
+
+/* Contribution of one simplex corner at offset X, Y, Z from the point. Falls off to 0 at a
+ * distance of sqrt(0.6), before the corners of the neighbouring simplices
+ */
+float AnoiseSimplexCorner(int Hash, float X, float Y, float Z)
+{
+    float t = 0.6f - X * X - Y * Y - Z * Z;
+
+    const float *g = grad3[Hash & 15];
+
+    /* Clamped rather than branched on. Which corners are in range is random */
+    t = (t > 0) ? t : 0;
+    t *= t;
+    return t * t * (g[0] * X + g[1] * Y + g[2] * Z);
+}
+
+int32_t AnoiseGradQ16(int Hash, int32_t X, int32_t Y, int32_t Z)
+{
+    int     h = Hash & 15;
+    int32_t u = h < 8 ? X : Y,
+            v = h < 4 ? Y : h == 12 || h == 14 ? X : Z;
+    return ((h & 1) == 0 ? u : -u) + ((h & 2) == 0 ? v : -v);
+}
+
+int32_t AnoiseSampleQ16(int32_t X, int32_t Y, int32_t Z)
+{
+    /* The arithmetic shift floors, the mask keeps the fraction */
+    int     xi = (X >> 16) & 0xFF, yi = (Y >> 16) & 0xFF, zi = (Z >> 16) & 0xFF;
+    int32_t x = X & 0xFFFF,
+            y = Y & 0xFFFF,
+            z = Z & 0xFFFF;
+    int32_t u = NOISE_FADE_Q16(x),
+            v = NOISE_FADE_Q16(y),
+            w = NOISE_FADE_Q16(z);
+    const int32_t one = ANOISE_Q16_ONE;
+
+    int A  = perm[xi] + yi,
+        AA = perm[A] + zi,
+        AB = perm[A + 1] + zi,
+        B  = perm[xi + 1] + yi,
+        BA = perm[B] + zi,
+        BB = perm[B + 1] + zi;
+
+    return NOISE_LERP_Q16(w,
+        NOISE_LERP_Q16(v, NOISE_LERP_Q16(u, AnoiseGradQ16(perm[AA], x, y, z),
+                                            AnoiseGradQ16(perm[BA], x - one, y, z)),
+                          NOISE_LERP_Q16(u, AnoiseGradQ16(perm[AB], x, y - one, z),
+                                            AnoiseGradQ16(perm[BB], x - one, y - one, z))),
+        NOISE_LERP_Q16(v, NOISE_LERP_Q16(u, AnoiseGradQ16(perm[AA + 1], x, y, z - one),
+                                            AnoiseGradQ16(perm[BA + 1], x - one, y, z - one)),
+                          NOISE_LERP_Q16(u, AnoiseGradQ16(perm[AB + 1], x, y - one, z - one),
+                                            AnoiseGradQ16(perm[BB + 1], x - one, y - one,
+                                                          z - one))));
+}
+
+/* Perlin noise with the lattice wrapped every Period units in x and y and PeriodZ units in z.
+ * Both must be powers of 2 up to 256
+ */
+float AnoiseSamplePeriodic(float X, float Y, float Z, int Period, int PeriodZ)
+{
+    int   mask = Period - 1, maskZ = PeriodZ - 1;
+    int   xi = (int)X, yi = (int)Y, zi = (int)Z;
+    xi -= (X < (float)xi);
+    yi -= (Y < (float)yi);
+    zi -= (Z < (float)zi);
+
+    float x = X - (float)xi,
+          y = Y - (float)yi,
+          z = Z - (float)zi;
+    float u = NOISE_FADE(x),
+          v = NOISE_FADE(y),
+          w = NOISE_FADE(z);
+
+    int x0 = xi & mask, x1 = (xi + 1) & mask;
+    int y0 = yi & mask, y1 = (yi + 1) & mask;
+    int z0 = zi & maskZ, z1 = (zi + 1) & maskZ;
+    int A  = perm[x0] + y0, B  = perm[x1] + y0;
+    int A1 = perm[x0] + y1, B1 = perm[x1] + y1;
+
+    return NOISE_LERP(w, NOISE_LERP(v, NOISE_LERP(u, AnoiseGrad(perm[perm[A] + z0], x, y, z),
+                                                     AnoiseGrad(perm[perm[B] + z0], x - 1, y, z)),
+                                       NOISE_LERP(u, AnoiseGrad(perm[perm[A1] + z0], x, y - 1, z),
+                                                     AnoiseGrad(perm[perm[B1] + z0], x - 1, y - 1, z))),
+                         NOISE_LERP(v, NOISE_LERP(u, AnoiseGrad(perm[perm[A] + z1], x, y, z - 1),
+                                                     AnoiseGrad(perm[perm[B] + z1], x - 1, y, z - 1)),
+                                       NOISE_LERP(u, AnoiseGrad(perm[perm[A1] + z1], x, y - 1, z - 1),
+                                                     AnoiseGrad(perm[perm[B1] + z1], x - 1, y - 1, z - 1))));
+}
+
+/* Converts a noise coordinate to 24.8 fixed point voxel coordinates, wrapped to Size voxels */
+int32_t AnoiseVolumeCoord(float X, uint32_t Size)
+{
+    X *= ANOISE_VOLUME_RES;
+    X -= Size * (float)(int32_t)(X / Size);
+    return (int32_t)(X * 256);
+}
+
+#if defined(ANOISE_SIMD_AVX2)
+/* ~~~~ AVX2: 8 samples per iteration, hash lookups through gathers ~~~~ */
+
+static inline __m256i AnoiseGather8(__m256i Idx)
+{
+    return _mm256_and_si256(_mm256_i32gather_epi32((const int *)perm, Idx, 1),
+                            _mm256_set1_epi32(0xFF));
+}
+
+static inline __m256 AnoiseFade8(__m256 T)
+{
+    __m256 r = _mm256_sub_ps(_mm256_mul_ps(T, _mm256_set1_ps(6.0f)), _mm256_set1_ps(15.0f));
+    r = _mm256_add_ps(_mm256_mul_ps(T, r), _mm256_set1_ps(10.0f));
+    return _mm256_mul_ps(_mm256_mul_ps(_mm256_mul_ps(T, T), T), r);
+}
+
+static inline __m256 AnoiseLerp8(__m256 T, __m256 A, __m256 B)
+{
+    return _mm256_add_ps(A, _mm256_mul_ps(T, _mm256_sub_ps(B, A)));
+}
+
+static inline __m256 AnoiseGrad8(__m256i Hash, __m256 X, __m256 Y, __m256 Z)
+{
+    __m256i h    = _mm256_and_si256(Hash, _mm256_set1_epi32(15));
+    __m256  lt8  = _mm256_castsi256_ps(_mm256_cmpgt_epi32(_mm256_set1_epi32(8), h));
+    __m256  lt4  = _mm256_castsi256_ps(_mm256_cmpgt_epi32(_mm256_set1_epi32(4), h));
+    __m256  useX = _mm256_castsi256_ps(_mm256_or_si256(
+                        _mm256_cmpeq_epi32(h, _mm256_set1_epi32(12)),
+                        _mm256_cmpeq_epi32(h, _mm256_set1_epi32(14))));
+    __m256  u    = _mm256_blendv_ps(Y, X, lt8);
+    __m256  v    = _mm256_blendv_ps(_mm256_blendv_ps(Z, X, useX), Y, lt4);
+    __m256  sU   = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_and_si256(h, _mm256_set1_epi32(1)), 31));
+    __m256  sV   = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_and_si256(h, _mm256_set1_epi32(2)), 30));
+    return _mm256_add_ps(_mm256_xor_ps(u, sU), _mm256_xor_ps(v, sV));
+}
+
+uint32_t AnoiseBatchSimd(const float *X, const float *Y, const float *Z, float *Out,
+                         uint32_t Count)
+{
+    const __m256i one  = _mm256_set1_epi32(1);
+    const __m256i mask = _mm256_set1_epi32(0xFF);
+    const __m256  oneF = _mm256_set1_ps(1.0f);
+    uint32_t i;
+
+    for (i = 0; i + 8 <= Count; i += 8) {
+        __m256 x  = _mm256_loadu_ps(X + i);
+        __m256 y  = _mm256_loadu_ps(Y + i);
+        __m256 z  = _mm256_loadu_ps(Z + i);
+        __m256 fx = _mm256_floor_ps(x);
+        __m256 fy = _mm256_floor_ps(y);
+        __m256 fz = _mm256_floor_ps(z);
+        __m256i xi = _mm256_and_si256(_mm256_cvttps_epi32(fx), mask);
+        __m256i yi = _mm256_and_si256(_mm256_cvttps_epi32(fy), mask);
+        __m256i zi = _mm256_and_si256(_mm256_cvttps_epi32(fz), mask);
+        x = _mm256_sub_ps(x, fx);
+        y = _mm256_sub_ps(y, fy);
+        z = _mm256_sub_ps(z, fz);
+        __m256 u = AnoiseFade8(x);
+        __m256 v = AnoiseFade8(y);
+        __m256 w = AnoiseFade8(z);
+
+        __m256i A  = _mm256_add_epi32(AnoiseGather8(xi), yi);
+        __m256i AA = _mm256_add_epi32(AnoiseGather8(A), zi);
+        __m256i AB = _mm256_add_epi32(AnoiseGather8(_mm256_add_epi32(A, one)), zi);
+        __m256i B  = _mm256_add_epi32(AnoiseGather8(_mm256_add_epi32(xi, one)), yi);
+        __m256i BA = _mm256_add_epi32(AnoiseGather8(B), zi);
+        __m256i BB = _mm256_add_epi32(AnoiseGather8(_mm256_add_epi32(B, one)), zi);
+
+        __m256 x1 = _mm256_sub_ps(x, oneF);
+        __m256 y1 = _mm256_sub_ps(y, oneF);
+        __m256 z1 = _mm256_sub_ps(z, oneF);
+
+        __m256 n = AnoiseLerp8(w,
+            AnoiseLerp8(v, AnoiseLerp8(u, AnoiseGrad8(AnoiseGather8(AA), x,  y,  z),
+                                          AnoiseGrad8(AnoiseGather8(BA), x1, y,  z)),
+                           AnoiseLerp8(u, AnoiseGrad8(AnoiseGather8(AB), x,  y1, z),
+                                          AnoiseGrad8(AnoiseGather8(BB), x1, y1, z))),
+            AnoiseLerp8(v, AnoiseLerp8(u, AnoiseGrad8(AnoiseGather8(_mm256_add_epi32(AA, one)), x,  y,  z1),
+                                          AnoiseGrad8(AnoiseGather8(_mm256_add_epi32(BA, one)), x1, y,  z1)),
+                           AnoiseLerp8(u, AnoiseGrad8(AnoiseGather8(_mm256_add_epi32(AB, one)), x,  y1, z1),
+                                          AnoiseGrad8(AnoiseGather8(_mm256_add_epi32(BB, one)), x1, y1, z1))));
+        _mm256_storeu_ps(Out + i, n);
+    }
+    return i;
+}
+
+#elif defined(ANOISE_SIMD_SSE41)
+/* ~~~~ SSE4.1: 4 samples per iteration, hash lookups per lane ~~~~ */
+
+static inline __m128i AnoiseGather4(__m128i Idx)
+{
+    return _mm_setr_epi32(perm[_mm_extract_epi32(Idx, 0)], perm[_mm_extract_epi32(Idx, 1)],
+                          perm[_mm_extract_epi32(Idx, 2)], perm[_mm_extract_epi32(Idx, 3)]);
+}
+
+static inline __m128 AnoiseFade4(__m128 T)
+{
+    __m128 r = _mm_sub_ps(_mm_mul_ps(T, _mm_set1_ps(6.0f)), _mm_set1_ps(15.0f));
+    r = _mm_add_ps(_mm_mul_ps(T, r), _mm_set1_ps(10.0f));
+    return _mm_mul_ps(_mm_mul_ps(_mm_mul_ps(T, T), T), r);
+}
+
+static inline __m128 AnoiseLerp4(__m128 T, __m128 A, __m128 B)
+{
+    return _mm_add_ps(A, _mm_mul_ps(T, _mm_sub_ps(B, A)));
+}
+
+static inline __m128 AnoiseGrad4(__m128i Hash, __m128 X, __m128 Y, __m128 Z)
+{
+    __m128i h    = _mm_and_si128(Hash, _mm_set1_epi32(15));
+    __m128  lt8  = _mm_castsi128_ps(_mm_cmplt_epi32(h, _mm_set1_epi32(8)));
+    __m128  lt4  = _mm_castsi128_ps(_mm_cmplt_epi32(h, _mm_set1_epi32(4)));
+    __m128  useX = _mm_castsi128_ps(_mm_or_si128(_mm_cmpeq_epi32(h, _mm_set1_epi32(12)),
+                                                 _mm_cmpeq_epi32(h, _mm_set1_epi32(14))));
+    __m128  u    = _mm_blendv_ps(Y, X, lt8);
+    __m128  v    = _mm_blendv_ps(_mm_blendv_ps(Z, X, useX), Y, lt4);
+    __m128  sU   = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(h, _mm_set1_epi32(1)), 31));
+    __m128  sV   = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(h, _mm_set1_epi32(2)), 30));
+    return _mm_add_ps(_mm_xor_ps(u, sU), _mm_xor_ps(v, sV));
+}
+
+uint32_t AnoiseBatchSimd(const float *X, const float *Y, const float *Z, float *Out,
+                         uint32_t Count)
+{
+    const __m128i one  = _mm_set1_epi32(1);
+    const __m128i mask = _mm_set1_epi32(0xFF);
+    const __m128  oneF = _mm_set1_ps(1.0f);
+    uint32_t i;
+
+    for (i = 0; i + 4 <= Count; i += 4) {
+        __m128 x  = _mm_loadu_ps(X + i);
+        __m128 y  = _mm_loadu_ps(Y + i);
+        __m128 z  = _mm_loadu_ps(Z + i);
+        __m128 fx = _mm_floor_ps(x);
+        __m128 fy = _mm_floor_ps(y);
+        __m128 fz = _mm_floor_ps(z);
+        __m128i xi = _mm_and_si128(_mm_cvttps_epi32(fx), mask);
+        __m128i yi = _mm_and_si128(_mm_cvttps_epi32(fy), mask);
+        __m128i zi = _mm_and_si128(_mm_cvttps_epi32(fz), mask);
+        x = _mm_sub_ps(x, fx);
+        y = _mm_sub_ps(y, fy);
+        z = _mm_sub_ps(z, fz);
+        __m128 u = AnoiseFade4(x);
+        __m128 v = AnoiseFade4(y);
+        __m128 w = AnoiseFade4(z);
+
+        __m128i A  = _mm_add_epi32(AnoiseGather4(xi), yi);
+        __m128i AA = _mm_add_epi32(AnoiseGather4(A), zi);
+        __m128i AB = _mm_add_epi32(AnoiseGather4(_mm_add_epi32(A, one)), zi);
+        __m128i B  = _mm_add_epi32(AnoiseGather4(_mm_add_epi32(xi, one)), yi);
+        __m128i BA = _mm_add_epi32(AnoiseGather4(B), zi);
+        __m128i BB = _mm_add_epi32(AnoiseGather4(_mm_add_epi32(B, one)), zi);
+
+        __m128 x1 = _mm_sub_ps(x, oneF);
+        __m128 y1 = _mm_sub_ps(y, oneF);
+        __m128 z1 = _mm_sub_ps(z, oneF);
+
+        __m128 n = AnoiseLerp4(w,
+            AnoiseLerp4(v, AnoiseLerp4(u, AnoiseGrad4(AnoiseGather4(AA), x,  y,  z),
+                                          AnoiseGrad4(AnoiseGather4(BA), x1, y,  z)),
+                           AnoiseLerp4(u, AnoiseGrad4(AnoiseGather4(AB), x,  y1, z),
+                                          AnoiseGrad4(AnoiseGather4(BB), x1, y1, z))),
+            AnoiseLerp4(v, AnoiseLerp4(u, AnoiseGrad4(AnoiseGather4(_mm_add_epi32(AA, one)), x,  y,  z1),
+                                          AnoiseGrad4(AnoiseGather4(_mm_add_epi32(BA, one)), x1, y,  z1)),
+                           AnoiseLerp4(u, AnoiseGrad4(AnoiseGather4(_mm_add_epi32(AB, one)), x,  y1, z1),
+                                          AnoiseGrad4(AnoiseGather4(_mm_add_epi32(BB, one)), x1, y1, z1))));
+        _mm_storeu_ps(Out + i, n);
+    }
+    return i;
+}
+
+#elif defined(ANOISE_SIMD_NEON)
+/* ~~~~ NEON: 4 samples per iteration, hash lookups per lane ~~~~ */
+
+static inline int32x4_t AnoiseGather4(int32x4_t Idx)
+{
+    int32_t idx[4];
+    int32_t val[4];
+
+    vst1q_s32(idx, Idx);
+    val[0] = perm[idx[0]];
+    val[1] = perm[idx[1]];
+    val[2] = perm[idx[2]];
+    val[3] = perm[idx[3]];
+    return vld1q_s32(val);
+}
+
+static inline float32x4_t AnoiseFade4(float32x4_t T)
+{
+    float32x4_t r = vsubq_f32(vmulq_n_f32(T, 6.0f), vdupq_n_f32(15.0f));
+    r = vaddq_f32(vmulq_f32(T, r), vdupq_n_f32(10.0f));
+    return vmulq_f32(vmulq_f32(vmulq_f32(T, T), T), r);
+}
+
+static inline float32x4_t AnoiseLerp4(float32x4_t T, float32x4_t A, float32x4_t B)
+{
+    return vaddq_f32(A, vmulq_f32(T, vsubq_f32(B, A)));
+}
+
+static inline float32x4_t AnoiseGrad4(int32x4_t Hash, float32x4_t X, float32x4_t Y,
+                                      float32x4_t Z)
+{
+    int32x4_t   h    = vandq_s32(Hash, vdupq_n_s32(15));
+    uint32x4_t  lt8  = vcltq_s32(h, vdupq_n_s32(8));
+    uint32x4_t  lt4  = vcltq_s32(h, vdupq_n_s32(4));
+    uint32x4_t  useX = vorrq_u32(vceqq_s32(h, vdupq_n_s32(12)), vceqq_s32(h, vdupq_n_s32(14)));
+    float32x4_t u    = vbslq_f32(lt8, X, Y);
+    float32x4_t v    = vbslq_f32(lt4, Y, vbslq_f32(useX, X, Z));
+    uint32x4_t  sU   = vshlq_n_u32(vreinterpretq_u32_s32(vandq_s32(h, vdupq_n_s32(1))), 31);
+    uint32x4_t  sV   = vshlq_n_u32(vreinterpretq_u32_s32(vandq_s32(h, vdupq_n_s32(2))), 30);
+    return vaddq_f32(vreinterpretq_f32_u32(veorq_u32(vreinterpretq_u32_f32(u), sU)),
+                     vreinterpretq_f32_u32(veorq_u32(vreinterpretq_u32_f32(v), sV)));
+}
+
+/* Floor that works on ARMv7 NEON, which lacks vrndmq_f32 */
+static inline int32x4_t AnoiseFloor4(float32x4_t X)
+{
+    int32x4_t t = vcvtq_s32_f32(X);
+    return vaddq_s32(t, vreinterpretq_s32_u32(vcgtq_f32(vcvtq_f32_s32(t), X)));
+}
+
+uint32_t AnoiseBatchSimd(const float *X, const float *Y, const float *Z, float *Out,
+                         uint32_t Count)
+{
+    const int32x4_t   one  = vdupq_n_s32(1);
+    const int32x4_t   mask = vdupq_n_s32(0xFF);
+    const float32x4_t oneF = vdupq_n_f32(1.0f);
+    uint32_t i;
+
+    for (i = 0; i + 4 <= Count; i += 4) {
+        float32x4_t x  = vld1q_f32(X + i);
+        float32x4_t y  = vld1q_f32(Y + i);
+        float32x4_t z  = vld1q_f32(Z + i);
+        int32x4_t   ix = AnoiseFloor4(x);
+        int32x4_t   iy = AnoiseFloor4(y);
+        int32x4_t   iz = AnoiseFloor4(z);
+        x = vsubq_f32(x, vcvtq_f32_s32(ix));
+        y = vsubq_f32(y, vcvtq_f32_s32(iy));
+        z = vsubq_f32(z, vcvtq_f32_s32(iz));
+        int32x4_t xi = vandq_s32(ix, mask);
+        int32x4_t yi = vandq_s32(iy, mask);
+        int32x4_t zi = vandq_s32(iz, mask);
+        float32x4_t u = AnoiseFade4(x);
+        float32x4_t v = AnoiseFade4(y);
+        float32x4_t w = AnoiseFade4(z);
+
+        int32x4_t A  = vaddq_s32(AnoiseGather4(xi), yi);
+        int32x4_t AA = vaddq_s32(AnoiseGather4(A), zi);
+        int32x4_t AB = vaddq_s32(AnoiseGather4(vaddq_s32(A, one)), zi);
+        int32x4_t B  = vaddq_s32(AnoiseGather4(vaddq_s32(xi, one)), yi);
+        int32x4_t BA = vaddq_s32(AnoiseGather4(B), zi);
+        int32x4_t BB = vaddq_s32(AnoiseGather4(vaddq_s32(B, one)), zi);
+
+        float32x4_t x1 = vsubq_f32(x, oneF);
+        float32x4_t y1 = vsubq_f32(y, oneF);
+        float32x4_t z1 = vsubq_f32(z, oneF);
+
+        float32x4_t n = AnoiseLerp4(w,
+            AnoiseLerp4(v, AnoiseLerp4(u, AnoiseGrad4(AnoiseGather4(AA), x,  y,  z),
+                                          AnoiseGrad4(AnoiseGather4(BA), x1, y,  z)),
+                           AnoiseLerp4(u, AnoiseGrad4(AnoiseGather4(AB), x,  y1, z),
+                                          AnoiseGrad4(AnoiseGather4(BB), x1, y1, z))),
+            AnoiseLerp4(v, AnoiseLerp4(u, AnoiseGrad4(AnoiseGather4(vaddq_s32(AA, one)), x,  y,  z1),
+                                          AnoiseGrad4(AnoiseGather4(vaddq_s32(BA, one)), x1, y,  z1)),
+                           AnoiseLerp4(u, AnoiseGrad4(AnoiseGather4(vaddq_s32(AB, one)), x,  y1, z1),
+                                          AnoiseGrad4(AnoiseGather4(vaddq_s32(BB, one)), x1, y1, z1))));
+        vst1q_f32(Out + i, n);
+    }
+    return i;
+}
+#endif
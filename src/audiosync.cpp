@@ -185,11 +185,11 @@ void AS_CalcLevelThresh(float MaxLevel, float DynamicRange, float LinearBlend)
 void AS_PlotFftTop(AniParms *Ap)
 {
     float level;
-    int16_t x, y;
+    int16_t x, y, r;
     uint16_t prevFreqBin;
-    uint8_t i;
-    uint8_t j, w;
+    uint8_t w;
     uint8_t hue;
+    CRGB col[LEDI_HEIGHT];
     uint16_t speed;
 
     CHSV hsvX;
@@ -224,26 +224,27 @@ void AS_PlotFftTop(AniParms *Ap)
             }
             crgb = hsvX;
             /* First row is always written */
-            //ANI_WritePixel(Ap, pXY(x, 0), crgb);
-            for (j = 0; j < w; j++) { ANI_WritePixel(Ap, pXY(x + j, 0), crgb); }
-            for (y = 1; y < LEDI_HEIGHT; y++) {
-
-                if (level >= levelThreshVert[y]) {
-                    if (Ap->mod & ANI_MOD_1) {
-                        hsvY.hue = hsvX.hue + ((y) * speed);
-                    }
-                    crgb = hsvY;
-                    //ANI_WritePixel(Ap, pXY(x, y), crgb);
-                    for (j = 0; j < w; j++) { ANI_WritePixel(Ap, pXY(x + j, y), crgb); }
-                } else {
-                    /* Black out this Pixel. All pixels above are already blacked out so exit loop */
-                    /* Need to black out all remain pixels since the last fft draw */
-                    for (i = y; i <= shownBinLevel[x]; i++) {
-                        //ANI_WritePixel(Ap, pXY(x, i), crgbBlack);
-                        for (j = 0; j < w; j++) { ANI_WritePixel(Ap, pXY(x + j, i), crgbBlack); }
-                    }
-                    break;
+            ANI_WriteRect(Ap, x, 0, w, 1, crgb);
+
+            /* The bar reaches down to the first row the level doesn't meet */
+            for (y = 1; y < LEDI_HEIGHT && level >= levelThreshVert[y]; y++) {
+            }
+            if (Ap->mod & ANI_MOD_1) {
+                for (r = 1; r < y; r++) {
+                    hsvY.hue = hsvX.hue + (r * speed);
+                    col[r] = hsvY;
+                }
+                for (r = x; r < x + w; r++) {
+                    ANI_WriteColumn(Ap, r, 1, &col[1], y - 1);
                 }
+            } else {
+                crgb = hsvY;
+                ANI_WriteRect(Ap, x, 1, w, y - 1, crgb);
+            }
+
+            /* Need to black out all remain pixels since the last fft draw */
+            if (y < LEDI_HEIGHT) {
+                ANI_WriteRect(Ap, x, y, w, shownBinLevel[x] - y + 1, crgbBlack);
             }
             shownBinLevel[x] = (y > 1) ? y - 1 : 0;
             prevFreqBin = fftBins[x] + 1;
@@ -276,12 +277,13 @@ void AS_PlotFftTop(AniParms *Ap)
 void AS_PlotFftBottom(AniParms *Ap)
 {
     float level;
-    int16_t x, y, i;
+    int16_t x, y, r;
     uint16_t prevFreqBin;
     uint8_t hue;
 
     CHSV hsv;
     CRGB crgb;
+    CRGB col[LEDI_HEIGHT];
     const CRGB crgbBlack = CRGB::Black;
 
     hue = Ap->hsv.h;
@@ -306,24 +308,28 @@ void AS_PlotFftBottom(AniParms *Ap)
                 hsv.hue = hue;
             }
             crgb = hsv;
-            /* First row is always written */
-            ANI_WritePixel(Ap, pXY_BL(x, 0), crgb);
-            for (y = 1; y < LEDI_HEIGHT; y++) {
-
-                if (level >= levelThreshVert[y]) {
-                    if (Ap->mod & ANI_MOD_1) {
-                        hsv.hue = hue + y;
-                        crgb = hsv;
-                    }
-                    ANI_WritePixel(Ap, pXY_BL(x, y), crgb);
-                } else {
-                    /* Black out this Pixel. All pixels above are already blacked out so exit loop */
-                        /* Need to black out all remain pixels since the last fft draw */
-                    for (i = y; i <= shownBinLevel[x]; i++) {
-                        ANI_WritePixel(Ap, pXY_BL(x, i), crgbBlack);
-                    }
-                    break;
+
+            /* The bar reaches up to the first row the level doesn't meet. Bar row r is
+             * frame row LEDI_HEIGHT - 1 - r
+             */
+            for (y = 1; y < LEDI_HEIGHT && level >= levelThreshVert[y]; y++) {
+            }
+            if (Ap->mod & ANI_MOD_1) {
+                /* First row is always written. The column is filled top to bottom */
+                col[LEDI_HEIGHT - 1] = crgb;
+                for (r = 1; r < y; r++) {
+                    hsv.hue = hue + r;
+                    col[LEDI_HEIGHT - 1 - r] = hsv;
                 }
+                ANI_WriteColumn(Ap, x, LEDI_HEIGHT - y, &col[LEDI_HEIGHT - y], y);
+            } else {
+                ANI_WriteRect(Ap, x, LEDI_HEIGHT - y, 1, y, crgb);
+            }
+
+            /* Need to black out all remain pixels since the last fft draw */
+            if (y < LEDI_HEIGHT) {
+                ANI_WriteRect(Ap, x, LEDI_HEIGHT - 1 - shownBinLevel[x], 1,
+                              shownBinLevel[x] - y + 1, crgbBlack);
             }
             shownBinLevel[x] = (y > 1) ? y - 1 : 0;
             prevFreqBin = fftBins[x] + 1;
@@ -361,7 +367,7 @@ void AS_PlotFftBottom(AniParms *Ap)
 void AS_PlotFftMid(AniParms *Ap)
 {
     float level;
-    int16_t x, y, i;
+    int16_t x, y, r, n;
     uint16_t prevFreqBin;
     uint16_t offset, speed;
     uint8_t hue;
@@ -369,6 +375,8 @@ void AS_PlotFftMid(AniParms *Ap)
     CHSV hsvX;
     CHSV hsvY;
     CRGB crgb;
+    CRGB colDown[LEDI_HEIGHT / 2];
+    CRGB colUp[LEDI_HEIGHT / 2];
     const CRGB crgbBlack = CRGB::Black;
 
     // Roughly Ap->hue goes up by 1 every Ap->scale per second
@@ -399,30 +407,41 @@ void AS_PlotFftMid(AniParms *Ap)
             }
             crgb = hsvX;
 
+            /* Bar row r goes down to frame row LEDI_HEIGHT / 2 + r and mirrored up to frame
+             * row LEDI_HEIGHT / 2 - 1 - r
+             */
+
             // Mid 2 rows are always on
-            ANI_WritePixel(Ap, pXY(x, LEDI_HEIGHT / 2), crgb);
-            ANI_WritePixel(Ap, pXY_BL(x, LEDI_HEIGHT / 2), crgb);
-            for (y = 1; (y < (offset + 1)) && (y < LEDI_HEIGHT / 2) ; y++) {
-                ANI_WritePixel(Ap, pXY(x, y + LEDI_HEIGHT / 2), crgbBlack);
-                ANI_WritePixel(Ap, pXY_BL(x, y + LEDI_HEIGHT / 2), crgbBlack);
+            ANI_WriteRect(Ap, x, LEDI_HEIGHT / 2 - 1, 1, 2, crgb);
+
+            // Followed by offset black rows
+            n = min((int16_t)offset, (int16_t)(LEDI_HEIGHT / 2 - 1));
+            ANI_WriteRect(Ap, x, LEDI_HEIGHT / 2 + 1, 1, n, crgbBlack);
+            ANI_WriteRect(Ap, x, LEDI_HEIGHT / 2 - 1 - n, 1, n, crgbBlack);
+
+            for (y = 1; y < LEDI_HEIGHT / 2 - offset && level >= levelThreshVert[y * 2 + offset]; y++) {
             }
-            for (y = 1; y < LEDI_HEIGHT / 2 - offset; y++) {
-
-                if (level >= levelThreshVert[y * 2 + offset]) {
-                    if (Ap->mod & ANI_MOD_1) {
-                        hsvY.hue = hsvX.hue + ((y * 2) * speed);
-                    }
-                    crgb = hsvY;
-
-                    ANI_WritePixel(Ap, pXY(x, y + LEDI_HEIGHT / 2 + offset), crgb);
-                    ANI_WritePixel(Ap, pXY_BL(x, y + LEDI_HEIGHT / 2 + offset), crgb);
-                } else {
-                    for (i = y; i <= shownBinLevel[x]; i++) {
-                        ANI_WritePixel(Ap, pXY(x, i + LEDI_HEIGHT / 2 + offset), crgbBlack);
-                        ANI_WritePixel(Ap, pXY_BL(x, i + LEDI_HEIGHT / 2 + offset), crgbBlack);
-                    }
-                    break;
+            if (Ap->mod & ANI_MOD_1) {
+                /* Both columns are filled top to bottom */
+                for (r = 1; r < y; r++) {
+                    hsvY.hue = hsvX.hue + ((r * 2) * speed);
+                    colDown[r - 1] = hsvY;
+                    colUp[y - 1 - r] = colDown[r - 1];
                 }
+                ANI_WriteColumn(Ap, x, LEDI_HEIGHT / 2 + offset + 1, colDown, y - 1);
+                ANI_WriteColumn(Ap, x, LEDI_HEIGHT / 2 - offset - y, colUp, y - 1);
+            } else {
+                crgb = hsvY;
+                ANI_WriteRect(Ap, x, LEDI_HEIGHT / 2 + offset + 1, 1, y - 1, crgb);
+                ANI_WriteRect(Ap, x, LEDI_HEIGHT / 2 - offset - y, 1, y - 1, crgb);
+            }
+
+            /* Need to black out all remain pixels since the last fft draw */
+            if (y < LEDI_HEIGHT / 2 - offset) {
+                ANI_WriteRect(Ap, x, LEDI_HEIGHT / 2 + offset + y, 1, shownBinLevel[x] - y + 1,
+                              crgbBlack);
+                ANI_WriteRect(Ap, x, LEDI_HEIGHT / 2 - 1 - offset - shownBinLevel[x], 1,
+                              shownBinLevel[x] - y + 1, crgbBlack);
             }
             prevFreqBin = fftBins[x] + 1;
             shownBinLevel[x] = ((y > 1) ? y - 1 : 0);
@@ -442,35 +461,41 @@ void AS_PlotFftMid(AniParms *Ap)
 void AS_RainbowIris(AniParms *Ap)
 {
     // FastLED's built-in rainbow generator
-    CHSV   hsvX, hsvY;
-    CRGB   crgb;
+    CHSV   hsvY;
+    CRGB   row[LEDI_WIDTH];
+    uint8_t hue[LEDI_WIDTH / 2];
+    uint8_t step[LEDI_WIDTH / 2];
     uint16_t x, y;
     uint16_t scale = Ap->scale;
     float  peakVal = 0;
     uint8_t peakU8 = 0;
 
     if (peak.available()) {
-        hsvX = Ap->hsv;
-        hsvY = hsvX;
         peakVal = peak.read();
         peakU8 = peakVal * 10.0;
 
+        /* Every column steps its hue down the rows by its own amount */
         for (x = 0; x < LEDI_WIDTH / 2; x++) {
             if ((x % 3) == 0) {
                 scale++;
             }
-            //hsvX.h += scale >> 2;
-            hsvY = hsvX;
-            for (y = 0; y < LEDI_HEIGHT / 2; y++) {
+            hue[x] = Ap->hsv.h;
+            step[x] = scale;
+        }
+
+        /* Build the top rows mirrored left to right and write each to its mirrored bottom row */
+        hsvY = Ap->hsv;
+        for (y = 0; y < LEDI_HEIGHT / 2; y++) {
+            for (x = 0; x < LEDI_WIDTH / 2; x++) {
                 if ((y % 3) == 0) {
-                    hsvY.h += scale;
-                }                
-                crgb = hsvY;
-                ANI_WritePixel(Ap, pXY(x, y), crgb);
-                ANI_WritePixel(Ap, pXY(x, LEDI_HEIGHT - 1 - y), crgb);
-                ANI_WritePixel(Ap, pXY(LEDI_WIDTH - 1 - x, y), crgb);
-                ANI_WritePixel(Ap, pXY(LEDI_WIDTH - 1 - x, LEDI_HEIGHT - 1 - y), crgb);
+                    hue[x] += step[x];
+                }
+                hsvY.h = hue[x];
+                row[x] = hsvY;
+                row[LEDI_WIDTH - 1 - x] = row[x];
             }
+            ANI_WriteSpan(Ap, pXY(0, y), row, LEDI_WIDTH);
+            ANI_WriteSpan(Ap, pXY(0, LEDI_HEIGHT - 1 - y), row, LEDI_WIDTH);
         }
     }
     EVERY_N_MILLISECONDS(40) {
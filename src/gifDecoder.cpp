@@ -97,7 +97,6 @@ bool GIFDEC_Init()
 
 void GIFDEC_Play(AniParms *Ap)
 {
-    uint16_t i;
     unsigned long now = millis();
 
     //ap_g = Ap;
@@ -149,9 +148,7 @@ void GIFDEC_Play(AniParms *Ap)
         currentFrameDelay = decoder.getFrameDelay_ms();
     }
 
-    for (i = 0; i < LEDI_NUM_LEDS; i++) {
-        ANI_WritePixel(Ap, i, prevFrame[i]);
-    }
+    ANI_WriteSpan(Ap, 0, prevFrame, LEDI_NUM_LEDS);
 
 }
 
@@ -234,6 +234,23 @@ void MtxMgr::run()
             backgroundLayer.swapBuffers(true);
         }
         matrix.countFPS();      // print the loop() frames per second to Serial
+    } else {
+        /* Nothing was due, sleep until the next animation is */
+        delay(ANI_MsToNextFrame());
+    }
+
+    /* Render times on demand. 't' prints them, 'r' starts over */
+    if (Serial.available() > 0) {
+        switch (Serial.read()) {
+        case 't':
+            ANI_ReportRenderTimes();
+            break;
+        case 'r':
+            ANI_ResetRenderTimes();
+            break;
+        default:
+            break;
+        }
     }
 #if 1
     EVERY_N_SECONDS(10) {